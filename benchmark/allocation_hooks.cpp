@@ -0,0 +1,141 @@
+/*
+ * Substitui operator new/delete globais no executável do benchmark para
+ * contar as alocações por fase (ver surrogate/allocation_counter.h).
+ * Todas as formas substituíveis passam pelo contador: simples, de vetor,
+ * nothrow, com tamanho (C++14) e alinhadas (C++17).
+ */
+
+#include <surrogate/allocation_counter.h>
+#include <cstdlib>
+#include <new>
+
+/* marca os contadores como instalados antes de main() */
+static struct SInstallAllocationCounter {
+   SInstallAllocationCounter() {
+      CAllocationCounter::Install();
+   }
+} s_sInstallAllocationCounter;
+
+
+static void* CountedNew(std::size_t un_size) {
+   CAllocationCounter::CountNew();
+   void* pvMemory = ::malloc(un_size > 0 ? un_size : 1);
+   if(pvMemory == NULL) throw std::bad_alloc();
+   return pvMemory;
+}
+
+
+static void* CountedNewNoThrow(std::size_t un_size) {
+   CAllocationCounter::CountNew();
+   return ::malloc(un_size > 0 ? un_size : 1);
+}
+
+
+static void CountedDelete(void* pv_memory) {
+   if(pv_memory == NULL) return;
+   CAllocationCounter::CountDelete();
+   ::free(pv_memory);
+}
+
+
+void* operator new(std::size_t un_size) {
+   return CountedNew(un_size);
+}
+
+void* operator new[](std::size_t un_size) {
+   return CountedNew(un_size);
+}
+
+void operator delete(void* pv_memory) throw() {
+   CountedDelete(pv_memory);
+}
+
+void operator delete[](void* pv_memory) throw() {
+   CountedDelete(pv_memory);
+}
+
+void* operator new(std::size_t un_size, const std::nothrow_t&) throw() {
+   return CountedNewNoThrow(un_size);
+}
+
+void* operator new[](std::size_t un_size, const std::nothrow_t&) throw() {
+   return CountedNewNoThrow(un_size);
+}
+
+void operator delete(void* pv_memory, const std::nothrow_t&) throw() {
+   CountedDelete(pv_memory);
+}
+
+void operator delete[](void* pv_memory, const std::nothrow_t&) throw() {
+   CountedDelete(pv_memory);
+}
+
+#if __cplusplus >= 201402L
+void operator delete(void* pv_memory, std::size_t) throw() {
+   CountedDelete(pv_memory);
+}
+
+void operator delete[](void* pv_memory, std::size_t) throw() {
+   CountedDelete(pv_memory);
+}
+#endif
+
+#ifdef __cpp_aligned_new
+/* alinhamento acima de __STDCPP_DEFAULT_NEW_ALIGNMENT__; free() libera posix_memalign() */
+static void* CountedAlignedNewNoThrow(std::size_t un_size, std::align_val_t e_align) noexcept {
+   CAllocationCounter::CountNew();
+   std::size_t unAlign = static_cast<std::size_t>(e_align);
+   if(unAlign < sizeof(void*)) unAlign = sizeof(void*);
+   void* pvMemory = NULL;
+   if(::posix_memalign(&pvMemory, unAlign, un_size > 0 ? un_size : 1) != 0) return NULL;
+   return pvMemory;
+}
+
+
+static void* CountedAlignedNew(std::size_t un_size, std::align_val_t e_align) {
+   void* pvMemory = CountedAlignedNewNoThrow(un_size, e_align);
+   if(pvMemory == NULL) throw std::bad_alloc();
+   return pvMemory;
+}
+
+
+void* operator new(std::size_t un_size, std::align_val_t e_align) {
+   return CountedAlignedNew(un_size, e_align);
+}
+
+void* operator new[](std::size_t un_size, std::align_val_t e_align) {
+   return CountedAlignedNew(un_size, e_align);
+}
+
+void* operator new(std::size_t un_size, std::align_val_t e_align, const std::nothrow_t&) noexcept {
+   return CountedAlignedNewNoThrow(un_size, e_align);
+}
+
+void* operator new[](std::size_t un_size, std::align_val_t e_align, const std::nothrow_t&) noexcept {
+   return CountedAlignedNewNoThrow(un_size, e_align);
+}
+
+void operator delete(void* pv_memory, std::align_val_t) noexcept {
+   CountedDelete(pv_memory);
+}
+
+void operator delete[](void* pv_memory, std::align_val_t) noexcept {
+   CountedDelete(pv_memory);
+}
+
+void operator delete(void* pv_memory, std::size_t, std::align_val_t) noexcept {
+   CountedDelete(pv_memory);
+}
+
+void operator delete[](void* pv_memory, std::size_t, std::align_val_t) noexcept {
+   CountedDelete(pv_memory);
+}
+
+void operator delete(void* pv_memory, std::align_val_t, const std::nothrow_t&) noexcept {
+   CountedDelete(pv_memory);
+}
+
+void operator delete[](void* pv_memory, std::align_val_t, const std::nothrow_t&) noexcept {
+   CountedDelete(pv_memory);
+}
+#endif
@@ -0,0 +1,489 @@
+#include "json_value.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+/* leitor recursivo descendente sobre o texto inteiro */
+class CJsonValue::CParser {
+
+public:
+
+   CParser(const std::string& str_text) :
+      m_strText(str_text),
+      m_unPos(0) {}
+
+   CJsonValue ParseDocument() {
+      CJsonValue cValue = ParseValue();
+      SkipSpaces();
+      if(m_unPos != m_strText.size()) {
+         Fail("unexpected trailing characters");
+      }
+      return cValue;
+   }
+
+private:
+
+   void Fail(const std::string& str_what) const {
+      /* linha do erro, para mensagens úteis ao editar as tolerâncias à mão */
+      UInt32 unLine = 1;
+      for(size_t i = 0; i < m_unPos && i < m_strText.size(); ++i) {
+         if(m_strText[i] == '\n') ++unLine;
+      }
+      THROW_ARGOSEXCEPTION("JSON parse error at line " << unLine << ": " << str_what);
+   }
+
+   void SkipSpaces() {
+      while(m_unPos < m_strText.size() &&
+            (m_strText[m_unPos] == ' ' || m_strText[m_unPos] == '\t' ||
+             m_strText[m_unPos] == '\n' || m_strText[m_unPos] == '\r')) {
+         ++m_unPos;
+      }
+   }
+
+   char Peek() {
+      SkipSpaces();
+      if(m_unPos >= m_strText.size()) {
+         Fail("unexpected end of input");
+      }
+      return m_strText[m_unPos];
+   }
+
+   void Expect(char ch_char) {
+      if(Peek() != ch_char) {
+         Fail(std::string("expected '") + ch_char + "'");
+      }
+      ++m_unPos;
+   }
+
+   bool Match(const char* pch_word) {
+      size_t unLength = std::char_traits<char>::length(pch_word);
+      if(m_strText.compare(m_unPos, unLength, pch_word) == 0) {
+         m_unPos += unLength;
+         return true;
+      }
+      return false;
+   }
+
+   CJsonValue ParseValue() {
+      char chNext = Peek();
+      if(chNext == '{') return ParseObject();
+      if(chNext == '[') return ParseArray();
+      if(chNext == '"') return CJsonValue(ParseString());
+      if(Match("null")) return CJsonValue();
+      if(Match("true")) return CJsonValue(true);
+      if(Match("false")) return CJsonValue(false);
+      return CJsonValue(ParseNumber());
+   }
+
+   CJsonValue ParseObject() {
+      CJsonValue cObject = CJsonValue::MakeObject();
+      Expect('{');
+      if(Peek() == '}') {
+         ++m_unPos;
+         return cObject;
+      }
+      while(true) {
+         if(Peek() != '"') {
+            Fail("expected a key");
+         }
+         std::string strKey = ParseString();
+         Expect(':');
+         cObject.Set(strKey, ParseValue());
+         if(Peek() == ',') {
+            ++m_unPos;
+            continue;
+         }
+         Expect('}');
+         return cObject;
+      }
+   }
+
+   CJsonValue ParseArray() {
+      CJsonValue cArray = CJsonValue::MakeArray();
+      Expect('[');
+      if(Peek() == ']') {
+         ++m_unPos;
+         return cArray;
+      }
+      while(true) {
+         cArray.GetArray().push_back(ParseValue());
+         if(Peek() == ',') {
+            ++m_unPos;
+            continue;
+         }
+         Expect(']');
+         return cArray;
+      }
+   }
+
+   std::string ParseString() {
+      Expect('"');
+      std::string strValue;
+      while(m_unPos < m_strText.size() && m_strText[m_unPos] != '"') {
+         char chChar = m_strText[m_unPos++];
+         if(chChar == '\\') {
+            if(m_unPos >= m_strText.size()) break;
+            chChar = m_strText[m_unPos++];
+            switch(chChar) {
+               case 'n': chChar = '\n'; break;
+               case 't': chChar = '\t'; break;
+               case 'r': chChar = '\r'; break;
+               case 'b': chChar = '\b'; break;
+               case 'f': chChar = '\f'; break;
+               case '"': case '\\': case '/': break;
+               case 'u':
+                  AppendUTF8(strValue, ParseCodePoint());
+                  continue;
+               default: Fail("unsupported escape sequence");
+            }
+         }
+         strValue += chChar;
+      }
+      if(m_unPos >= m_strText.size()) {
+         Fail("unterminated string");
+      }
+      ++m_unPos;
+      return strValue;
+   }
+
+   UInt32 ParseHex4() {
+      if(m_unPos + 4 > m_strText.size()) {
+         Fail("truncated \\u escape");
+      }
+      UInt32 unValue = 0;
+      for(size_t i = 0; i < 4; ++i) {
+         char chDigit = m_strText[m_unPos++];
+         unValue <<= 4;
+         if(chDigit >= '0' && chDigit <= '9')      unValue |= chDigit - '0';
+         else if(chDigit >= 'a' && chDigit <= 'f') unValue |= chDigit - 'a' + 10;
+         else if(chDigit >= 'A' && chDigit <= 'F') unValue |= chDigit - 'A' + 10;
+         else Fail("invalid \\u escape");
+      }
+      return unValue;
+   }
+
+   /* os 4 dígitos hexadecimais do escape; fora do plano básico vem um par substituto */
+   UInt32 ParseCodePoint() {
+      UInt32 unCode = ParseHex4();
+      if(unCode >= 0xDC00 && unCode <= 0xDFFF) {
+         Fail("unpaired low surrogate in \\u escape");
+      }
+      if(unCode >= 0xD800 && unCode <= 0xDBFF) {
+         if(! Match("\\u")) {
+            Fail("unpaired high surrogate in \\u escape");
+         }
+         UInt32 unLow = ParseHex4();
+         if(unLow < 0xDC00 || unLow > 0xDFFF) {
+            Fail("unpaired high surrogate in \\u escape");
+         }
+         unCode = 0x10000 + ((unCode - 0xD800) << 10) + (unLow - 0xDC00);
+      }
+      return unCode;
+   }
+
+   static void AppendUTF8(std::string& str_out, UInt32 un_code) {
+      if(un_code < 0x80) {
+         str_out += static_cast<char>(un_code);
+      }
+      else if(un_code < 0x800) {
+         str_out += static_cast<char>(0xC0 | (un_code >> 6));
+         str_out += static_cast<char>(0x80 | (un_code & 0x3F));
+      }
+      else if(un_code < 0x10000) {
+         str_out += static_cast<char>(0xE0 | (un_code >> 12));
+         str_out += static_cast<char>(0x80 | ((un_code >> 6) & 0x3F));
+         str_out += static_cast<char>(0x80 | (un_code & 0x3F));
+      }
+      else {
+         str_out += static_cast<char>(0xF0 | (un_code >> 18));
+         str_out += static_cast<char>(0x80 | ((un_code >> 12) & 0x3F));
+         str_out += static_cast<char>(0x80 | ((un_code >> 6) & 0x3F));
+         str_out += static_cast<char>(0x80 | (un_code & 0x3F));
+      }
+   }
+
+   /* avança sobre os dígitos a partir da posição atual, devolve quantos havia */
+   size_t SkipDigits() {
+      size_t unStart = m_unPos;
+      while(m_unPos < m_strText.size() &&
+            m_strText[m_unPos] >= '0' && m_strText[m_unPos] <= '9') {
+         ++m_unPos;
+      }
+      return m_unPos - unStart;
+   }
+
+   /*
+    * Só a gramática do JSON: -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+    * strtod sozinho aceitaria nan, inf, hexadecimais e '+' no início.
+    */
+   double ParseNumber() {
+      size_t unStart = m_unPos;
+      if(m_unPos < m_strText.size() && m_strText[m_unPos] == '-') {
+         ++m_unPos;
+      }
+      if(m_unPos < m_strText.size() && m_strText[m_unPos] == '0') {
+         ++m_unPos;
+      }
+      else if(SkipDigits() == 0) {
+         Fail("unexpected character");
+      }
+      if(m_unPos < m_strText.size() && m_strText[m_unPos] == '.') {
+         ++m_unPos;
+         if(SkipDigits() == 0) {
+            Fail("expected a digit after '.'");
+         }
+      }
+      if(m_unPos < m_strText.size() &&
+         (m_strText[m_unPos] == 'e' || m_strText[m_unPos] == 'E')) {
+         ++m_unPos;
+         if(m_unPos < m_strText.size() &&
+            (m_strText[m_unPos] == '+' || m_strText[m_unPos] == '-')) {
+            ++m_unPos;
+         }
+         if(SkipDigits() == 0) {
+            Fail("expected a digit in the exponent");
+         }
+      }
+      return ::strtod(m_strText.substr(unStart, m_unPos - unStart).c_str(), NULL);
+   }
+
+private:
+
+   const std::string& m_strText;
+   size_t m_unPos;
+};
+
+/****************************************/
+/****************************************/
+
+CJsonValue::CJsonValue() :
+   m_eType(TYPE_NULL),
+   m_bBool(false),
+   m_fNumber(0.0) {}
+
+
+CJsonValue::CJsonValue(bool b_value) :
+   m_eType(TYPE_BOOL),
+   m_bBool(b_value),
+   m_fNumber(0.0) {}
+
+
+CJsonValue::CJsonValue(double f_value) :
+   m_eType(TYPE_NUMBER),
+   m_bBool(false),
+   m_fNumber(f_value) {}
+
+
+CJsonValue::CJsonValue(const char* pch_value) :
+   m_eType(TYPE_STRING),
+   m_bBool(false),
+   m_fNumber(0.0),
+   m_strString(pch_value) {}
+
+
+CJsonValue::CJsonValue(const std::string& str_value) :
+   m_eType(TYPE_STRING),
+   m_bBool(false),
+   m_fNumber(0.0),
+   m_strString(str_value) {}
+
+
+CJsonValue CJsonValue::MakeArray() {
+   CJsonValue cValue;
+   cValue.m_eType = TYPE_ARRAY;
+   return cValue;
+}
+
+
+CJsonValue CJsonValue::MakeObject() {
+   CJsonValue cValue;
+   cValue.m_eType = TYPE_OBJECT;
+   return cValue;
+}
+
+
+CJsonValue CJsonValue::Load(const std::string& str_file) {
+   std::ifstream cInput(str_file.c_str());
+   if(! cInput) {
+      THROW_ARGOSEXCEPTION("Can't open \"" << str_file << "\"");
+   }
+   std::ostringstream cText;
+   cText << cInput.rdbuf();
+   try {
+      return Parse(cText.str());
+   }
+   catch(CARGoSException& ex) {
+      THROW_ARGOSEXCEPTION_NESTED("Error reading \"" << str_file << "\"", ex);
+   }
+}
+
+
+void CJsonValue::Save(const std::string& str_file) const {
+   /* grava ao lado e renomeia: uma falha no meio não corrompe a linha de base */
+   std::string strTemp = str_file + ".tmp";
+   std::ofstream cOutput(strTemp.c_str(), std::ios_base::trunc | std::ios_base::out);
+   Write(cOutput);
+   cOutput << std::endl;
+   cOutput.close();
+   if(! cOutput || ::rename(strTemp.c_str(), str_file.c_str()) != 0) {
+      THROW_ARGOSEXCEPTION("Can't write \"" << str_file << "\"");
+   }
+}
+
+
+CJsonValue CJsonValue::Parse(const std::string& str_text) {
+   CParser cParser(str_text);
+   return cParser.ParseDocument();
+}
+
+
+static void WriteString(std::ostream& c_out, const std::string& str_value) {
+   c_out << '"';
+   for(size_t i = 0; i < str_value.size(); ++i) {
+      switch(str_value[i]) {
+         case '"':  c_out << "\\\""; break;
+         case '\\': c_out << "\\\\"; break;
+         case '\n': c_out << "\\n";  break;
+         case '\t': c_out << "\\t";  break;
+         case '\r': c_out << "\\r";  break;
+         default:
+            if(static_cast<unsigned char>(str_value[i]) < 0x20) {
+               /* demais caracteres de controle; UTF-8 passa como está */
+               char pchEscape[8];
+               ::snprintf(pchEscape, sizeof(pchEscape), "\\u%04x",
+                          static_cast<unsigned int>(static_cast<unsigned char>(str_value[i])));
+               c_out << pchEscape;
+            }
+            else {
+               c_out << str_value[i];
+            }
+      }
+   }
+   c_out << '"';
+}
+
+
+void CJsonValue::Write(std::ostream& c_out, UInt32 un_indent) const {
+   std::string strIndent(un_indent + 2, ' ');
+   switch(m_eType) {
+      case TYPE_NULL:
+         c_out << "null";
+         break;
+      case TYPE_BOOL:
+         c_out << (m_bBool ? "true" : "false");
+         break;
+      case TYPE_NUMBER: {
+         /* o menor número de dígitos que relido dá o mesmo double (no máximo 17),
+          * assim gravar e reler não muda os valores e 0.15 continua 0.15 */
+         char pchBuffer[32];
+         for(int nDigits = 15; nDigits <= 17; ++nDigits) {
+            ::snprintf(pchBuffer, sizeof(pchBuffer), "%.*g", nDigits, m_fNumber);
+            if(::strtod(pchBuffer, NULL) == m_fNumber) break;
+         }
+         c_out << pchBuffer;
+         break;
+      }
+      case TYPE_STRING:
+         WriteString(c_out, m_strString);
+         break;
+      case TYPE_ARRAY:
+         c_out << "[";
+         for(size_t i = 0; i < m_vecArray.size(); ++i) {
+            c_out << (i > 0 ? ", " : "");
+            m_vecArray[i].Write(c_out, un_indent);
+         }
+         c_out << "]";
+         break;
+      case TYPE_OBJECT:
+         if(m_vecObject.empty()) {
+            c_out << "{}";
+            break;
+         }
+         c_out << "{\n";
+         for(size_t i = 0; i < m_vecObject.size(); ++i) {
+            c_out << strIndent;
+            WriteString(c_out, m_vecObject[i].first);
+            c_out << ": ";
+            m_vecObject[i].second.Write(c_out, un_indent + 2);
+            c_out << (i + 1 < m_vecObject.size() ? ",\n" : "\n");
+         }
+         c_out << std::string(un_indent, ' ') << "}";
+         break;
+   }
+}
+
+
+void CJsonValue::CheckType(EType e_type) const {
+   static const char* TYPE_NAMES[] = { "null", "boolean", "number", "string", "array", "object" };
+   if(m_eType != e_type) {
+      THROW_ARGOSEXCEPTION("JSON value is a " << TYPE_NAMES[m_eType]
+                           << ", expected a " << TYPE_NAMES[e_type]);
+   }
+}
+
+
+bool CJsonValue::GetBool() const {
+   CheckType(TYPE_BOOL);
+   return m_bBool;
+}
+
+
+double CJsonValue::GetNumber() const {
+   CheckType(TYPE_NUMBER);
+   return m_fNumber;
+}
+
+
+const std::string& CJsonValue::GetString() const {
+   CheckType(TYPE_STRING);
+   return m_strString;
+}
+
+
+const CJsonValue::TArray& CJsonValue::GetArray() const {
+   CheckType(TYPE_ARRAY);
+   return m_vecArray;
+}
+
+
+CJsonValue::TArray& CJsonValue::GetArray() {
+   CheckType(TYPE_ARRAY);
+   return m_vecArray;
+}
+
+
+bool CJsonValue::Has(const std::string& str_key) const {
+   CheckType(TYPE_OBJECT);
+   for(size_t i = 0; i < m_vecObject.size(); ++i) {
+      if(m_vecObject[i].first == str_key) return true;
+   }
+   return false;
+}
+
+
+const CJsonValue& CJsonValue::Get(const std::string& str_key) const {
+   CheckType(TYPE_OBJECT);
+   for(size_t i = 0; i < m_vecObject.size(); ++i) {
+      if(m_vecObject[i].first == str_key) return m_vecObject[i].second;
+   }
+   THROW_ARGOSEXCEPTION("JSON object has no member \"" << str_key << "\"");
+}
+
+
+void CJsonValue::Set(const std::string& str_key, const CJsonValue& c_value) {
+   CheckType(TYPE_OBJECT);
+   for(size_t i = 0; i < m_vecObject.size(); ++i) {
+      if(m_vecObject[i].first == str_key) {
+         m_vecObject[i].second = c_value;
+         return;
+      }
+   }
+   m_vecObject.push_back(std::make_pair(str_key, c_value));
+}
+
+
+const CJsonValue::TObject& CJsonValue::GetObject() const {
+   CheckType(TYPE_OBJECT);
+   return m_vecObject;
+}
@@ -0,0 +1,90 @@
+#ifndef JSON_VALUE_H
+#define JSON_VALUE_H
+
+/*
+ * JSON mínimo para os arquivos de linha de base do benchmark: null, booleanos,
+ * números, strings, listas e objetos. Os objetos guardam a ordem das chaves,
+ * assim um arquivo reescrito por --record só muda onde os valores mudaram.
+ */
+
+#include <argos3/core/utility/configuration/argos_exception.h>
+#include <argos3/core/utility/datatypes/datatypes.h>
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace argos;
+
+class CJsonValue {
+
+public:
+
+   enum EType {
+      TYPE_NULL = 0,
+      TYPE_BOOL,
+      TYPE_NUMBER,
+      TYPE_STRING,
+      TYPE_ARRAY,
+      TYPE_OBJECT
+   };
+
+   typedef std::vector<CJsonValue> TArray;
+   typedef std::vector< std::pair<std::string, CJsonValue> > TObject;
+
+public:
+
+   CJsonValue();
+   CJsonValue(bool b_value);
+   CJsonValue(double f_value);
+   /* sem esta sobrecarga, um literal como "abc" viraria o booleano true */
+   CJsonValue(const char* pch_value);
+   CJsonValue(const std::string& str_value);
+
+   static CJsonValue MakeArray();
+   static CJsonValue MakeObject();
+
+   /* lê/grava um arquivo inteiro, lança CARGoSException em caso de erro */
+   static CJsonValue Load(const std::string& str_file);
+   void Save(const std::string& str_file) const;
+
+   static CJsonValue Parse(const std::string& str_text);
+   void Write(std::ostream& c_out, UInt32 un_indent = 0) const;
+
+   inline EType GetType() const {
+      return m_eType;
+   }
+
+   inline bool IsNull() const {
+      return m_eType == TYPE_NULL;
+   }
+
+   bool GetBool() const;
+   double GetNumber() const;
+   const std::string& GetString() const;
+   const TArray& GetArray() const;
+   TArray& GetArray();
+
+   /* membros de objeto: Get() lança se a chave não existir, Set() substitui ou acrescenta */
+   bool Has(const std::string& str_key) const;
+   const CJsonValue& Get(const std::string& str_key) const;
+   void Set(const std::string& str_key, const CJsonValue& c_value);
+   const TObject& GetObject() const;
+
+private:
+
+   class CParser;
+
+   void CheckType(EType e_type) const;
+
+private:
+
+   EType m_eType;
+   bool m_bBool;
+   double m_fNumber;
+   std::string m_strString;
+   TArray m_vecArray;
+   TObject m_vecObject;
+};
+
+#endif
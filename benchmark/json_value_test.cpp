@@ -0,0 +1,142 @@
+/*
+ * Testes do JSON das linhas de base: gravar e reler não pode mudar nenhum
+ * valor, e o leitor aceita o que outras ferramentas costumam gerar.
+ *
+ * uso: json_value_test [diretório_de_linhas_de_base]
+ */
+
+#include "json_value.h"
+#include <testing/unit_test.h>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+
+static std::string ToText(const CJsonValue& c_value) {
+   std::ostringstream cOut;
+   c_value.Write(cOut);
+   return cOut.str();
+}
+
+static bool ParseFails(const std::string& str_text) {
+   try {
+      CJsonValue::Parse(str_text);
+   }
+   catch(CARGoSException&) {
+      return true;
+   }
+   return false;
+}
+
+/****************************************/
+/****************************************/
+
+static void TestNumbers() {
+   const double pfValues[] = {
+      0.1 + 0.2, 1.0 / 3.0, 0.15, 1e-6, 123456789.123456789, -2.5e-300, 1e300, 0.0, -1.0, 3000.0
+   };
+   for(size_t i = 0; i < sizeof(pfValues) / sizeof(pfValues[0]); ++i) {
+      CJsonValue cReread = CJsonValue::Parse(ToText(CJsonValue(pfValues[i])));
+      CHECK(cReread.GetNumber() == pfValues[i]);
+   }
+   /* valores escritos à mão continuam legíveis depois de regravados */
+   CHECK(ToText(CJsonValue(0.15)) == "0.15");
+   CHECK(ToText(CJsonValue(1e-6)) == "1e-06");
+   CHECK(ToText(CJsonValue(3000.0)) == "3000");
+   CHECK(ToText(CJsonValue(-1.0)) == "-1");
+   /* só a gramática do JSON */
+   CHECK(CJsonValue::Parse("-0.5e+2").GetNumber() == -50.0);
+   CHECK(CJsonValue::Parse("0").GetNumber() == 0.0);
+   const char* pchInvalid[] = {
+      "nan", "NaN", "inf", "-Infinity", "0x10", "+1", "01", "1.", ".5", "1e", "1e+", "-"
+   };
+   for(size_t i = 0; i < sizeof(pchInvalid) / sizeof(pchInvalid[0]); ++i) {
+      CHECK(ParseFails(pchInvalid[i]));
+   }
+}
+
+
+static void TestStrings() {
+   /* 'é' (2 bytes), '€' (3 bytes) e um par substituto (4 bytes) */
+   CHECK(CJsonValue::Parse("\"caf\\u00e9\"").GetString() == "caf\xC3\xA9");
+   CHECK(CJsonValue::Parse("\"\\u20AC\"").GetString() == "\xE2\x82\xAC");
+   CHECK(CJsonValue::Parse("\"\\ud83d\\ude00\"").GetString() == "\xF0\x9F\x98\x80");
+   CHECK(CJsonValue::Parse("\"a\\/b\\b\\f\"").GetString() == "a/b\b\f");
+   CHECK(ParseFails("\"\\ud83d\""));
+   CHECK(ParseFails("\"\\ude00\""));
+   CHECK(ParseFails("\"\\u12\""));
+   CHECK(ParseFails("\"\\u12g4\""));
+   /* controle, aspas, barra e UTF-8 voltam iguais */
+   std::string strText("a\"b\\c\n\t\r\x01 caf\xC3\xA9");
+   CJsonValue cReread = CJsonValue::Parse(ToText(CJsonValue(strText)));
+   CHECK(cReread.GetString() == strText);
+   CHECK(ToText(CJsonValue(std::string("\x01"))) == "\"\\u0001\"");
+   /* literal de C é string, não booleano */
+   CHECK(CJsonValue("abc").GetType() == CJsonValue::TYPE_STRING);
+   CHECK(CJsonValue("abc").GetString() == "abc");
+}
+
+
+static void TestStructure() {
+   CJsonValue cObject = CJsonValue::Parse("{\"z\": 1, \"a\": [true, false, null], \"m\": {}}");
+   /* a ordem das chaves é a do arquivo */
+   CHECK(cObject.GetObject().size() == 3);
+   CHECK(cObject.GetObject()[0].first == "z");
+   CHECK(cObject.GetObject()[1].first == "a");
+   CHECK(cObject.Get("a").GetArray().size() == 3);
+   CHECK(cObject.Get("a").GetArray()[0].GetBool());
+   CHECK(cObject.Get("a").GetArray()[2].IsNull());
+   cObject.Set("a", CJsonValue(2.0));
+   cObject.Set("b", CJsonValue(3.0));
+   CHECK(cObject.GetObject()[1].first == "a");
+   CHECK(cObject.GetObject()[3].first == "b");
+   CHECK(ToText(CJsonValue::Parse(ToText(cObject))) == ToText(cObject));
+   CHECK(ParseFails("{\"a\": [1, 2,]}"));
+   CHECK(ParseFails("{\"a\" 1}"));
+   CHECK(ParseFails("[1] 2"));
+   CHECK(ParseFails("{\"a\": 1"));
+   CHECK(! cObject.Has("c"));
+   bool bThrown = false;
+   try {
+      cObject.Get("a").GetString();
+   }
+   catch(CARGoSException&) {
+      bThrown = true;
+   }
+   CHECK(bThrown);
+}
+
+
+static void TestBaselines(const std::string& str_dir) {
+   const char* pchFiles[] = { "footbot_0010.json", "footbot_0100.json", "footbot_1000.json" };
+   for(size_t i = 0; i < sizeof(pchFiles) / sizeof(pchFiles[0]); ++i) {
+      CJsonValue cFile = CJsonValue::Load(str_dir + "/" + pchFiles[i]);
+      CHECK(cFile.Get("scenario").Get("robots").GetNumber() > 0);
+      CHECK(cFile.Has("tolerance"));
+      CHECK(cFile.Has("baseline"));
+      /* regravar um arquivo sem mudanças não muda o texto */
+      std::string strTemp = std::string("json_value_test_") + pchFiles[i];
+      cFile.Save(strTemp);
+      CHECK(ToText(CJsonValue::Load(strTemp)) == ToText(cFile));
+      ::remove(strTemp.c_str());
+   }
+}
+
+/****************************************/
+/****************************************/
+
+int main(int argc, char** argv) {
+   try {
+      TestNumbers();
+      TestStrings();
+      TestStructure();
+      if(argc > 1) {
+         TestBaselines(argv[1]);
+      }
+   }
+   catch(CARGoSException& ex) {
+      std::cerr << ex.what() << std::endl;
+      return 1;
+   }
+   return TestResult();
+}
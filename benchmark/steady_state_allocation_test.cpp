@@ -0,0 +1,89 @@
+/*
+ * Teste do passo sem alocações: depois do aquecimento, nenhuma fase do motor
+ * substituto pode chamar operator new, nem quando o número de vizinhos de
+ * range and bearing de cada robô muda de um passo para outro.
+ *
+ * uso: steady_state_allocation_test benchmark.argos
+ */
+
+#include <surrogate/allocation_counter.h>
+#include <surrogate/surrogate_engine.h>
+#include <testing/unit_test.h>
+#include <iostream>
+#include <vector>
+
+/* cenário curto: robôs saem do ninho e voltam, a densidade muda a cada passo */
+static const UInt32 ROBOTS       = 100;
+static const UInt32 WARMUP_TICKS = 200;
+static const UInt32 TICKS        = 300;
+static const UInt32 SEED         = 123;
+/* alcance do range and bearing no motor substituto */
+static const Real RAB_RANGE      = 3.0f;
+
+/* vizinhos no alcance do range and bearing, contados sem alocar */
+static UInt32 CountNeighbours(CSurrogateEngine& c_engine, size_t un_robot) {
+   UInt32 unNeighbours = 0;
+   CVector2 cPosition = c_engine.GetPosition(un_robot);
+   for(size_t j = 0; j < c_engine.GetNumRobots(); ++j) {
+      if(j != un_robot &&
+         (c_engine.GetPosition(j) - cPosition).SquareLength() <= RAB_RANGE * RAB_RANGE) {
+         ++unNeighbours;
+      }
+   }
+   return unNeighbours;
+}
+
+/****************************************/
+/****************************************/
+
+int main(int argc, char** argv) {
+   if(argc < 2) {
+      std::cerr << "uso: " << argv[0] << " benchmark.argos" << std::endl;
+      return 1;
+   }
+   if(! CAllocationCounter::IsInstalled()) {
+      std::cerr << "operator new/delete sem contagem: ligar benchmark/allocation_hooks.cpp" << std::endl;
+      return 1;
+   }
+   try {
+      CSurrogateEngine cEngine;
+      cEngine.SetRandomSeed(SEED);
+      cEngine.SetNumRobots(ROBOTS);
+      cEngine.SetLength(WARMUP_TICKS + TICKS);
+      cEngine.SetOutputFile("/dev/null");
+      cEngine.Init(argv[1]);
+      for(UInt32 t = 0; t < WARMUP_TICKS; ++t) {
+         cEngine.Step();
+      }
+      /* vizinhos de cada robô no passo anterior, alocado antes da medição */
+      std::vector<UInt32> vecLast(cEngine.GetNumRobots(), 0);
+      UInt32 unChanges = 0;
+      CAllocationCounter::Reset();
+      for(UInt32 t = 0; t < TICKS; ++t) {
+         /* só os passos do motor são contados, não o laço do teste */
+         CAllocationCounter::SetEnabled(true);
+         cEngine.Step();
+         CAllocationCounter::SetEnabled(false);
+         for(size_t i = 0; i < cEngine.GetNumRobots(); ++i) {
+            UInt32 unNeighbours = CountNeighbours(cEngine, i);
+            if(cEngine.GetController(i).IsResting() && unNeighbours != vecLast[i]) ++unChanges;
+            vecLast[i] = unNeighbours;
+         }
+      }
+      for(UInt32 p = 0; p < CSurrogateEngine::NUM_PHASES; ++p) {
+         if(CAllocationCounter::GetNews(p) > 0) {
+            std::cerr << CSurrogateEngine::GetPhaseName(static_cast<CSurrogateEngine::EPhase>(p))
+                      << ": " << CAllocationCounter::GetNews(p) << " alocações" << std::endl;
+         }
+         CHECK(CAllocationCounter::GetNews(p) == 0);
+      }
+      /* o cenário tem de exercitar a troca do número de pacotes */
+      CHECK(unChanges > 0);
+      cEngine.Destroy();
+   }
+   catch(CARGoSException& ex) {
+      std::cerr << ex.what() << std::endl;
+      return 1;
+   }
+   return TestResult();
+}
@@ -0,0 +1,360 @@
+/*
+ * swarm_benchmark: roda cenários fixos (semente, robôs, passos) no motor
+ * substituto, sem visualização, e compara com as linhas de base gravadas.
+ *
+ * uso: swarm_benchmark [--record] [--allow-missing-baseline] [-r repetições]
+ *                       linha_de_base.json|diretório ...
+ *
+ * Cada arquivo de linha de base descreve um cenário ("scenario"), as
+ * tolerâncias ("tolerance") e os valores medidos ("baseline"). Sem --record
+ * o programa compara e termina com 1 se alguma métrica sair da tolerância;
+ * com --record ele reescreve "baseline" com os valores medidos agora.
+ *
+ * Cada repetição roda "warmup_ticks" passos sem medir e depois "ticks" passos
+ * medidos. Métricas:
+ *  - ticks_per_second:      passos por segundo (maior é melhor);
+ *  - phase_us_per_tick:     microssegundos por passo em cada fase (menor é melhor);
+ *  - allocations_per_tick:  chamadas a operator new por passo em cada fase;
+ *  - ticks_to_detection:    passo do primeiro alvo encontrado, -1 se nenhum;
+ *  - resting_fraction:      fração média de robôs descansando.
+ * A saída também mostra robôs x passos por segundo e os bytes por robô do
+ * FootBotTrack (informativos, fora da comparação).
+ * As duas últimas medem o comportamento: qualquer desvio é uma regressão.
+ *
+ * Depois do aquecimento o passo não pode alocar: qualquer operator new nos
+ * passos medidos reprova o cenário, com ou sem linha de base gravada.
+ * Cenário sem linha de base ("baseline": null) também reprova, a não ser com
+ * --allow-missing-baseline, que reduz a falta a um aviso (máquina nova, antes
+ * de rodar --record).
+ *
+ * Só o motor substituto é medido: CTrackingRules é o mesmo do ARGoS, mas
+ * CTrackingLoopFunctions::PreStep e a física do ARGoS ficam fora.
+ *
+ * Os tempos são o melhor de várias repetições, para reduzir o ruído da máquina.
+ */
+
+#include "json_value.h"
+#include <footbot_tracking/footbot_tracking.h>
+#include <surrogate/allocation_counter.h>
+#include <surrogate/surrogate_engine.h>
+#include <argos3/core/utility/logging/argos_log.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <dirent.h>
+#include <sys/stat.h>
+
+/****************************************/
+/****************************************/
+
+struct SMeasurement {
+   Real TicksPerSecond;
+   Real PhaseUsPerTick[CSurrogateEngine::NUM_PHASES];
+   Real AllocationsPerTick[CSurrogateEngine::NUM_PHASES];
+   UInt64 Allocations;                  // total nos passos medidos
+   SInt64 TicksToDetection;
+   Real RestingFraction;
+};
+
+
+static Real Now() {
+   timespec tTime;
+   ::clock_gettime(CLOCK_MONOTONIC, &tTime);
+   return tTime.tv_sec + tTime.tv_nsec * 1e-9;
+}
+
+// roda o cenário un_repetitions vezes e guarda o melhor tempo de cada métrica
+
+static SMeasurement Measure(const CJsonValue& c_scenario, UInt32 un_repetitions) {
+   const std::string& strExperiment = c_scenario.Get("experiment").GetString();
+   UInt32 unRobots = static_cast<UInt32>(c_scenario.Get("robots").GetNumber());
+   UInt32 unTicks = static_cast<UInt32>(c_scenario.Get("ticks").GetNumber());
+   UInt32 unWarmup = static_cast<UInt32>(c_scenario.Get("warmup_ticks").GetNumber());
+   UInt32 unSeed = static_cast<UInt32>(c_scenario.Get("seed").GetNumber());
+   if(unTicks == 0) {
+      THROW_ARGOSEXCEPTION("Scenario \"ticks\" must be greater than zero");
+   }
+   SMeasurement sBest;
+   for(UInt32 r = 0; r < un_repetitions; ++r) {
+      CSurrogateEngine cEngine;
+      cEngine.SetRandomSeed(unSeed);
+      cEngine.SetNumRobots(unRobots);
+      cEngine.SetLength(unWarmup + unTicks);
+      cEngine.SetOutputFile("/dev/null");
+      cEngine.Init(strExperiment);
+      for(UInt32 t = 0; t < unWarmup; ++t) {
+         cEngine.Step();
+      }
+      cEngine.ResetPhaseTimes();
+      CAllocationCounter::Reset();
+      CAllocationCounter::SetEnabled(true);
+      Real fStart = Now();
+      cEngine.Execute();
+      Real fElapsed = Now() - fStart;
+      CAllocationCounter::SetEnabled(false);
+      const CSurrogateEngine::SStatistics& sStats = cEngine.GetStatistics();
+      SMeasurement sRun;
+      sRun.TicksPerSecond = unTicks / fElapsed;
+      for(UInt32 p = 0; p < CSurrogateEngine::NUM_PHASES; ++p) {
+         sRun.PhaseUsPerTick[p] =
+            1e6 * cEngine.GetPhaseTime(static_cast<CSurrogateEngine::EPhase>(p)) / unTicks;
+      }
+      sRun.Allocations = 0;
+      for(UInt32 p = 0; p < CSurrogateEngine::NUM_PHASES; ++p) {
+         sRun.AllocationsPerTick[p] = static_cast<Real>(CAllocationCounter::GetNews(p)) / unTicks;
+         sRun.Allocations += CAllocationCounter::GetNews(p);
+      }
+      sRun.TicksToDetection = sStats.FirstDetection;
+      UInt64 unSamples = sStats.WalkingSum + sStats.RestingSum;
+      sRun.RestingFraction = unSamples > 0 ? static_cast<Real>(sStats.RestingSum) / unSamples : 0.0f;
+      cEngine.Destroy();
+      if(r == 0) {
+         sBest = sRun;
+         continue;
+      }
+      /* a semente é fixa: o comportamento tem de se repetir exatamente */
+      if(sRun.TicksToDetection != sBest.TicksToDetection ||
+         sRun.RestingFraction != sBest.RestingFraction) {
+         THROW_ARGOSEXCEPTION("Non-deterministic run: outcome changed between repetitions");
+      }
+      sBest.TicksPerSecond = Max(sBest.TicksPerSecond, sRun.TicksPerSecond);
+      for(UInt32 p = 0; p < CSurrogateEngine::NUM_PHASES; ++p) {
+         sBest.PhaseUsPerTick[p] = Min(sBest.PhaseUsPerTick[p], sRun.PhaseUsPerTick[p]);
+         /* alocações: vale a pior repetição */
+         sBest.AllocationsPerTick[p] = Max(sBest.AllocationsPerTick[p], sRun.AllocationsPerTick[p]);
+      }
+      sBest.Allocations = Max(sBest.Allocations, sRun.Allocations);
+   }
+   return sBest;
+}
+
+
+static CJsonValue ToJson(const SMeasurement& s_measurement) {
+   CJsonValue cPhases = CJsonValue::MakeObject();
+   CJsonValue cAllocations = CJsonValue::MakeObject();
+   for(UInt32 p = 0; p < CSurrogateEngine::NUM_PHASES; ++p) {
+      const char* pchPhase = CSurrogateEngine::GetPhaseName(static_cast<CSurrogateEngine::EPhase>(p));
+      cPhases.Set(pchPhase, CJsonValue(static_cast<double>(s_measurement.PhaseUsPerTick[p])));
+      cAllocations.Set(pchPhase, CJsonValue(static_cast<double>(s_measurement.AllocationsPerTick[p])));
+   }
+   CJsonValue cResult = CJsonValue::MakeObject();
+   cResult.Set("ticks_per_second", CJsonValue(static_cast<double>(s_measurement.TicksPerSecond)));
+   cResult.Set("phase_us_per_tick", cPhases);
+   cResult.Set("allocations_per_tick", cAllocations);
+   cResult.Set("ticks_to_detection", CJsonValue(static_cast<double>(s_measurement.TicksToDetection)));
+   cResult.Set("resting_fraction", CJsonValue(static_cast<double>(s_measurement.RestingFraction)));
+   return cResult;
+}
+
+/****************************************/
+/****************************************/
+
+/* sentido permitido da variação de cada métrica */
+enum EDirection {
+   HIGHER_IS_BETTER,
+   LOWER_IS_BETTER,
+   EXACT
+};
+
+// compara uma métrica: margem = |linha de base| * relative + absolute
+
+static bool CheckMetric(const std::string& str_name,
+                        double f_baseline,
+                        double f_measured,
+                        const CJsonValue& c_tolerance,
+                        EDirection e_direction) {
+   double fMargin = std::fabs(f_baseline) * c_tolerance.Get("relative").GetNumber() +
+                    c_tolerance.Get("absolute").GetNumber();
+   bool bOk;
+   switch(e_direction) {
+      case HIGHER_IS_BETTER: bOk = f_measured >= f_baseline - fMargin; break;
+      case LOWER_IS_BETTER:  bOk = f_measured <= f_baseline + fMargin; break;
+      default:               bOk = std::fabs(f_measured - f_baseline) <= fMargin; break;
+   }
+   LOG << "   " << str_name
+       << ": " << f_measured
+       << " (linha de base " << f_baseline
+       << ", margem " << fMargin << ")"
+       << (bOk ? "" : "  REGRESSÃO")
+       << std::endl;
+   return bOk;
+}
+
+
+static bool Check(const CJsonValue& c_baseline,
+                  const CJsonValue& c_tolerance,
+                  const CJsonValue& c_measured) {
+   bool bOk = true;
+   bOk &= CheckMetric("ticks_per_second",
+                      c_baseline.Get("ticks_per_second").GetNumber(),
+                      c_measured.Get("ticks_per_second").GetNumber(),
+                      c_tolerance.Get("ticks_per_second"),
+                      HIGHER_IS_BETTER);
+   for(UInt32 p = 0; p < CSurrogateEngine::NUM_PHASES; ++p) {
+      std::string strPhase = CSurrogateEngine::GetPhaseName(static_cast<CSurrogateEngine::EPhase>(p));
+      bOk &= CheckMetric("phase_us_per_tick." + strPhase,
+                         c_baseline.Get("phase_us_per_tick").Get(strPhase).GetNumber(),
+                         c_measured.Get("phase_us_per_tick").Get(strPhase).GetNumber(),
+                         c_tolerance.Get("phase_us_per_tick"),
+                         LOWER_IS_BETTER);
+   }
+   for(UInt32 p = 0; p < CSurrogateEngine::NUM_PHASES; ++p) {
+      std::string strPhase = CSurrogateEngine::GetPhaseName(static_cast<CSurrogateEngine::EPhase>(p));
+      bOk &= CheckMetric("allocations_per_tick." + strPhase,
+                         c_baseline.Get("allocations_per_tick").Get(strPhase).GetNumber(),
+                         c_measured.Get("allocations_per_tick").Get(strPhase).GetNumber(),
+                         c_tolerance.Get("allocations_per_tick"),
+                         LOWER_IS_BETTER);
+   }
+   bOk &= CheckMetric("ticks_to_detection",
+                      c_baseline.Get("ticks_to_detection").GetNumber(),
+                      c_measured.Get("ticks_to_detection").GetNumber(),
+                      c_tolerance.Get("ticks_to_detection"),
+                      EXACT);
+   bOk &= CheckMetric("resting_fraction",
+                      c_baseline.Get("resting_fraction").GetNumber(),
+                      c_measured.Get("resting_fraction").GetNumber(),
+                      c_tolerance.Get("resting_fraction"),
+                      EXACT);
+   return bOk;
+}
+
+/****************************************/
+/****************************************/
+
+// expande diretórios nos arquivos .json que eles contêm, em ordem alfabética
+
+static void CollectFiles(const std::string& str_path, std::vector<std::string>& vec_files) {
+   struct stat tInfo;
+   if(::stat(str_path.c_str(), &tInfo) != 0) {
+      THROW_ARGOSEXCEPTION("Can't find \"" << str_path << "\"");
+   }
+   if(! S_ISDIR(tInfo.st_mode)) {
+      vec_files.push_back(str_path);
+      return;
+   }
+   DIR* ptDir = ::opendir(str_path.c_str());
+   if(ptDir == NULL) {
+      THROW_ARGOSEXCEPTION("Can't open directory \"" << str_path << "\"");
+   }
+   std::vector<std::string> vecFound;
+   while(dirent* ptEntry = ::readdir(ptDir)) {
+      std::string strName = ptEntry->d_name;
+      if(strName.size() > 5 && strName.compare(strName.size() - 5, 5, ".json") == 0) {
+         vecFound.push_back(str_path + "/" + strName);
+      }
+   }
+   ::closedir(ptDir);
+   std::sort(vecFound.begin(), vecFound.end());
+   vec_files.insert(vec_files.end(), vecFound.begin(), vecFound.end());
+}
+
+
+static void PrintUsage(const char* pch_program) {
+   LOGERR << "uso: " << pch_program
+          << " [--record] [--allow-missing-baseline] [-r repetições]"
+          << " linha_de_base.json|diretório ..."
+          << std::endl;
+}
+
+
+int main(int argc, char** argv) {
+   bool bRecord = false;
+   bool bAllowMissingBaseline = false;
+   UInt32 unRepetitions = 3;
+   std::vector<std::string> vecPaths;
+   for(int i = 1; i < argc; ++i) {
+      if(::strcmp(argv[i], "--record") == 0) {
+         bRecord = true;
+      }
+      else if(::strcmp(argv[i], "--allow-missing-baseline") == 0) {
+         bAllowMissingBaseline = true;
+      }
+      else if(::strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+         unRepetitions = ::strtoul(argv[++i], NULL, 10);
+      }
+      else if(argv[i][0] == '-') {
+         PrintUsage(argv[0]);
+         return 1;
+      }
+      else {
+         vecPaths.push_back(argv[i]);
+      }
+   }
+   if(vecPaths.empty() || unRepetitions == 0) {
+      PrintUsage(argv[0]);
+      return 1;
+   }
+   if(! CAllocationCounter::IsInstalled()) {
+      LOGERR << "operator new/delete sem contagem: ligar benchmark/allocation_hooks.cpp" << std::endl;
+      LOGERR.Flush();
+      return 1;
+   }
+   UInt32 unFailed = 0;
+   try {
+      std::vector<std::string> vecFiles;
+      for(size_t i = 0; i < vecPaths.size(); ++i) {
+         CollectFiles(vecPaths[i], vecFiles);
+      }
+      for(size_t i = 0; i < vecFiles.size(); ++i) {
+         CJsonValue cFile = CJsonValue::Load(vecFiles[i]);
+         const CJsonValue& cScenario = cFile.Get("scenario");
+         LOG << vecFiles[i] << ": "
+             << cScenario.Get("robots").GetNumber() << " robôs, "
+             << cScenario.Get("ticks").GetNumber() << " passos"
+             << std::endl;
+         LOG.Flush();
+         SMeasurement sMeasurement = Measure(cScenario, unRepetitions);
+         CJsonValue cMeasured = ToJson(sMeasurement);
+         /* vazão e memória do controlador por robô, para comparar entre versões */
+         LOG << "   " << sMeasurement.TicksPerSecond << " passos/s, "
+             << sMeasurement.TicksPerSecond * cScenario.Get("robots").GetNumber() << " robôs x passos/s, "
+             << sizeof(FootBotTrack) << " bytes por robô no FootBotTrack ("
+             << sizeof(FootBotTrack::SStateData) << " de estado)"
+             << std::endl;
+         if(sMeasurement.Allocations > 0) {
+            /* não depende de linha de base: o passo após o aquecimento não aloca */
+            LOGERR << "   " << sMeasurement.Allocations << " alocações após o aquecimento:";
+            for(UInt32 p = 0; p < CSurrogateEngine::NUM_PHASES; ++p) {
+               LOGERR << " " << CSurrogateEngine::GetPhaseName(static_cast<CSurrogateEngine::EPhase>(p))
+                      << "=" << sMeasurement.AllocationsPerTick[p] * cScenario.Get("ticks").GetNumber();
+            }
+            LOGERR << std::endl;
+            ++unFailed;
+         }
+         else if(bRecord) {
+            cFile.Set("baseline", cMeasured);
+            cFile.Save(vecFiles[i]);
+            LOG << "   linha de base gravada" << std::endl;
+         }
+         else if(cFile.Get("baseline").IsNull()) {
+            /* sem linha de base não há com o que comparar: só passa se pedido */
+            LOGERR << "   " << (bAllowMissingBaseline ? "aviso" : "erro")
+                   << ": sem linha de base, só as alocações foram verificadas;"
+                   << " rode \"make perf-baseline\" e versione o resultado" << std::endl;
+            if(! bAllowMissingBaseline) {
+               ++unFailed;
+            }
+         }
+         else if(! Check(cFile.Get("baseline"), cFile.Get("tolerance"), cMeasured)) {
+            ++unFailed;
+         }
+         LOG.Flush();
+         LOGERR.Flush();
+      }
+   }
+   catch(CARGoSException& ex) {
+      LOGERR << ex.what() << std::endl;
+      LOG.Flush();
+      LOGERR.Flush();
+      return 1;
+   }
+   if(unFailed > 0) {
+      LOGERR << unFailed << " cenário(s) reprovado(s)" << std::endl;
+   }
+   LOG.Flush();
+   LOGERR.Flush();
+   return unFailed > 0 ? 1 : 0;
+}
@@ -2,17 +2,7 @@
 #include <argos3/core/utility/configuration/argos_configuration.h>
 #include <argos3/core/utility/math/vector2.h>
 #include <argos3/core/utility/logging/argos_log.h>
-
-FootBotTrack::Alvo::Alvo() :
-   AlvoSpotted(false),
-   AlvoID(0),
-   TotalAlvos(0) {}
-
-void FootBotTrack::Alvo::Reset() {
-   AlvoSpotted = false;
-   AlvoID = 0;
-   TotalAlvos = 0;
-}
+#include <list>
 
 // parametros de do algoritmo de difusão
 
@@ -29,7 +19,6 @@ void FootBotTrack::SDiffusionParams::Init(TConfigurationNode& t_node) {
 // parametros de movimento da roda
 
 void FootBotTrack::SWheelTurningParams::Init(TConfigurationNode& t_node) {
-  TurningMechanism = NO_TURN;
   CDegrees cAngle;
   GetNodeAttribute(t_node, "hard_turn_angle_threshold", cAngle);
   HardTurnOnAngleThreshold = ToRadians(cAngle);
@@ -40,10 +29,10 @@ void FootBotTrack::SWheelTurningParams::Init(TConfigurationNode& t_node) {
   GetNodeAttribute(t_node, "max_speed", MaxSpeed);
 }
 
-FootBotTrack::SStateData::SStateData() :
+FootBotTrack::SStateParams::SStateParams() :
    ProbRange(0.0f, 1.0f) {}
 
-void FootBotTrack::SStateData::Init(TConfigurationNode& t_node) {
+void FootBotTrack::SStateParams::Init(TConfigurationNode& t_node) {
     GetNodeAttribute(t_node, "initial_rest_to_explore_prob", InitialRestToExploreProb);
     GetNodeAttribute(t_node, "initial_explore_to_rest_prob", InitialExploreToRestProb);
     GetNodeAttribute(t_node, "food_rule_explore_to_rest_delta_prob", FoodRuleExploreToRestDeltaProb);
@@ -51,21 +40,75 @@ void FootBotTrack::SStateData::Init(TConfigurationNode& t_node) {
     GetNodeAttribute(t_node, "collision_rule_explore_to_rest_delta_prob", CollisionRuleExploreToRestDeltaProb);
     GetNodeAttribute(t_node, "social_rule_rest_to_explore_delta_prob", SocialRuleRestToExploreDeltaProb);
     GetNodeAttribute(t_node, "social_rule_explore_to_rest_delta_prob", SocialRuleExploreToRestDeltaProb);
+    // os contadores por robô têm 16 bits e saturam em 0xFFFF
     GetNodeAttribute(t_node, "minimum_resting_time", MinimumRestingTime);
     GetNodeAttribute(t_node, "minimum_unsuccessful_explore_time", MinimumUnsuccessfulExploreTime);
     GetNodeAttribute(t_node, "minimum_search_for_place_in_nest_time", MinimumSearchForPlaceInNestTime);
+    if(MinimumRestingTime == 0xFFFF ||
+       MinimumUnsuccessfulExploreTime == 0xFFFF ||
+       MinimumSearchForPlaceInNestTime == 0xFFFF) {
+       THROW_ARGOSEXCEPTION("minimum_* times must be smaller than 65535 ticks");
+    }
+}
+
+bool FootBotTrack::SSharedParams::operator==(const SSharedParams& s_other) const {
+   return
+      Diffusion.Delta == s_other.Diffusion.Delta &&
+      Diffusion.GoStraightAngleRange.GetMin().GetValue() == s_other.Diffusion.GoStraightAngleRange.GetMin().GetValue() &&
+      Diffusion.GoStraightAngleRange.GetMax().GetValue() == s_other.Diffusion.GoStraightAngleRange.GetMax().GetValue() &&
+      WheelTurning.HardTurnOnAngleThreshold.GetValue() == s_other.WheelTurning.HardTurnOnAngleThreshold.GetValue() &&
+      WheelTurning.SoftTurnOnAngleThreshold.GetValue() == s_other.WheelTurning.SoftTurnOnAngleThreshold.GetValue() &&
+      WheelTurning.NoTurnAngleThreshold.GetValue() == s_other.WheelTurning.NoTurnAngleThreshold.GetValue() &&
+      WheelTurning.MaxSpeed == s_other.WheelTurning.MaxSpeed &&
+      State.InitialRestToExploreProb == s_other.State.InitialRestToExploreProb &&
+      State.InitialExploreToRestProb == s_other.State.InitialExploreToRestProb &&
+      State.FoodRuleExploreToRestDeltaProb == s_other.State.FoodRuleExploreToRestDeltaProb &&
+      State.FoodRuleRestToExploreDeltaProb == s_other.State.FoodRuleRestToExploreDeltaProb &&
+      State.CollisionRuleExploreToRestDeltaProb == s_other.State.CollisionRuleExploreToRestDeltaProb &&
+      State.SocialRuleRestToExploreDeltaProb == s_other.State.SocialRuleRestToExploreDeltaProb &&
+      State.SocialRuleExploreToRestDeltaProb == s_other.State.SocialRuleExploreToRestDeltaProb &&
+      State.MinimumRestingTime == s_other.State.MinimumRestingTime &&
+      State.MinimumUnsuccessfulExploreTime == s_other.State.MinimumUnsuccessfulExploreTime &&
+      State.MinimumSearchForPlaceInNestTime == s_other.State.MinimumSearchForPlaceInNestTime;
+}
+
+const FootBotTrack::SSharedParams* FootBotTrack::SSharedParams::Intern(const SSharedParams& s_params) {
+   // std::list: os endereços não mudam quando novas configurações são inseridas
+   static std::list<SSharedParams> lstInstances;
+   for(std::list<SSharedParams>::const_iterator it = lstInstances.begin();
+       it != lstInstances.end();
+       ++it) {
+      if(*it == s_params) return &*it;
+   }
+   lstInstances.push_back(s_params);
+   LOG << "[INFO] FootBotTrack: " << sizeof(FootBotTrack) << " bytes por robô ("
+       << sizeof(SStateData) << " de estado), "
+       << sizeof(SSharedParams) << " bytes de parâmetros compartilhados"
+       << std::endl;
+   return &lstInstances.back();
 }
 
-void FootBotTrack::SStateData::Reset() {
+void FootBotTrack::SStateData::Reset(const SStateParams& s_params) {
    State = STATE_RESTING;
+   LastExplorationResult = LAST_EXPLORATION_NONE;
    InNest = true;
-   RestToExploreProb = InitialRestToExploreProb;
-   ExploreToRestProb = InitialExploreToRestProb;
+   AlvoSpotted = false;
+   AlvoID = 0;
+   CoverageBiasX = 0.0f;
+   CoverageBiasY = 0.0f;
+   RestToExploreProb = s_params.InitialRestToExploreProb;
+   ExploreToRestProb = s_params.InitialExploreToRestProb;
    TimeExploringUnsuccessfully = 0;
-   TimeRested = MinimumRestingTime;
+   TimeRested = s_params.MinimumRestingTime;
    TimeSearchingForPlaceInNest = 0;
 }
 
+// incrementa um contador de 16 bits sem dar a volta
+
+static inline void Tick(UInt16& un_counter) {
+   if(un_counter < 0xFFFF) ++un_counter;
+}
+
 
 FootBotTrack::FootBotTrack() :
    m_pcWheels(NULL),
@@ -75,7 +118,8 @@ FootBotTrack::FootBotTrack() :
    m_pcProximity(NULL),
    m_pcLight(NULL),
    m_pcGround(NULL),
-   m_pcRNG(NULL) {}
+   m_pcRNG(NULL),
+   m_psParams(NULL) {}
 
 void FootBotTrack::Init(TConfigurationNode& t_node) {
 
@@ -87,14 +131,20 @@ void FootBotTrack::Init(TConfigurationNode& t_node) {
   m_pcLight     = GetSensor  <CCI_FootBotLightSensor          >("footbot_light"        );
   m_pcGround    = GetSensor  <CCI_FootBotMotorGroundSensor    >("footbot_motor_ground" );
 
-  m_sDiffusionParams.Init(GetNode(t_node, "diffusion"));
+  SSharedParams sParams;
 
-  m_sWheelTurningParams.Init(GetNode(t_node, "wheel_turning"));
+  sParams.Diffusion.Init(GetNode(t_node, "diffusion"));
 
-  m_sStateData.Init(GetNode(t_node, "state"));
+  sParams.WheelTurning.Init(GetNode(t_node, "wheel_turning"));
+
+  sParams.State.Init(GetNode(t_node, "state"));
+
+  m_psParams = SSharedParams::Intern(sParams);
 
 
    m_pcRNG = CRandom::CreateRNG("argos");
+   // só no Init, como antes: Reset() não muda o modo de giro
+   m_sStateData.TurningMechanism = SWheelTurningParams::NO_TURN;
    Reset();
 }
 
@@ -121,10 +171,8 @@ void FootBotTrack::ControlStep() {
 
 
 void FootBotTrack::Reset() {
-   m_sStateData.Reset();
-   m_Alvo.Reset();
+   m_sStateData.Reset(m_psParams->State);
    m_pcLEDs->SetAllColors(CColor::RED);
-   m_eLastExplorationResult = LAST_EXPLORATION_NONE;
    m_pcRABA->ClearData();
    m_pcRABA->SetData(0, LAST_EXPLORATION_NONE);
 }
@@ -177,8 +225,8 @@ CVector2 FootBotTrack::DiffusionVector(bool& b_collision) {
    /* If the angle of the vector is small enough and the closest obstacle
       is far enough, ignore the vector and go straight, otherwise return
       it */
-   if(m_sDiffusionParams.GoStraightAngleRange.WithinMinBoundIncludedMaxBoundIncluded(cDiffusionVector.Angle()) &&
-      cDiffusionVector.Length() < m_sDiffusionParams.Delta ) {
+   if(m_psParams->Diffusion.GoStraightAngleRange.WithinMinBoundIncludedMaxBoundIncluded(cDiffusionVector.Angle()) &&
+      cDiffusionVector.Length() < m_psParams->Diffusion.Delta ) {
       b_collision = false;
       return CVector2::X;
    }
@@ -193,46 +241,47 @@ CVector2 FootBotTrack::DiffusionVector(bool& b_collision) {
 // faz com que o robõ se direcione a ela
 
 void FootBotTrack::SetWheelSpeedsFromVector(const CVector2& c_heading) {
+   const SWheelTurningParams& sTurning = m_psParams->WheelTurning;
    CRadians cHeadingAngle = c_heading.Angle().SignedNormalize();
    Real fHeadingLength = c_heading.Length();
-   Real fBaseAngularWheelSpeed = Min<Real>(fHeadingLength, m_sWheelTurningParams.MaxSpeed);
-   if(m_sWheelTurningParams.TurningMechanism == SWheelTurningParams::HARD_TURN) {
-      if(Abs(cHeadingAngle) <= m_sWheelTurningParams.SoftTurnOnAngleThreshold) {
-         m_sWheelTurningParams.TurningMechanism = SWheelTurningParams::SOFT_TURN;
+   Real fBaseAngularWheelSpeed = Min<Real>(fHeadingLength, sTurning.MaxSpeed);
+   if(m_sStateData.TurningMechanism == SWheelTurningParams::HARD_TURN) {
+      if(Abs(cHeadingAngle) <= sTurning.SoftTurnOnAngleThreshold) {
+         m_sStateData.TurningMechanism = SWheelTurningParams::SOFT_TURN;
       }
    }
-   if(m_sWheelTurningParams.TurningMechanism == SWheelTurningParams::SOFT_TURN) {
-      if(Abs(cHeadingAngle) > m_sWheelTurningParams.HardTurnOnAngleThreshold) {
-         m_sWheelTurningParams.TurningMechanism = SWheelTurningParams::HARD_TURN;
+   if(m_sStateData.TurningMechanism == SWheelTurningParams::SOFT_TURN) {
+      if(Abs(cHeadingAngle) > sTurning.HardTurnOnAngleThreshold) {
+         m_sStateData.TurningMechanism = SWheelTurningParams::HARD_TURN;
       }
-      else if(Abs(cHeadingAngle) <= m_sWheelTurningParams.NoTurnAngleThreshold) {
-         m_sWheelTurningParams.TurningMechanism = SWheelTurningParams::NO_TURN;
+      else if(Abs(cHeadingAngle) <= sTurning.NoTurnAngleThreshold) {
+         m_sStateData.TurningMechanism = SWheelTurningParams::NO_TURN;
       }
    }
-   if(m_sWheelTurningParams.TurningMechanism == SWheelTurningParams::NO_TURN) {
-      if(Abs(cHeadingAngle) > m_sWheelTurningParams.HardTurnOnAngleThreshold) {
-         m_sWheelTurningParams.TurningMechanism = SWheelTurningParams::HARD_TURN;
+   if(m_sStateData.TurningMechanism == SWheelTurningParams::NO_TURN) {
+      if(Abs(cHeadingAngle) > sTurning.HardTurnOnAngleThreshold) {
+         m_sStateData.TurningMechanism = SWheelTurningParams::HARD_TURN;
       }
-      else if(Abs(cHeadingAngle) > m_sWheelTurningParams.NoTurnAngleThreshold) {
-         m_sWheelTurningParams.TurningMechanism = SWheelTurningParams::SOFT_TURN;
+      else if(Abs(cHeadingAngle) > sTurning.NoTurnAngleThreshold) {
+         m_sStateData.TurningMechanism = SWheelTurningParams::SOFT_TURN;
       }
    }
    Real fSpeed1, fSpeed2;
-   switch(m_sWheelTurningParams.TurningMechanism) {
+   switch(m_sStateData.TurningMechanism) {
       case SWheelTurningParams::NO_TURN: {
          fSpeed1 = fBaseAngularWheelSpeed;
          fSpeed2 = fBaseAngularWheelSpeed;
          break;
       }
       case SWheelTurningParams::SOFT_TURN: {
-         Real fSpeedFactor = (m_sWheelTurningParams.HardTurnOnAngleThreshold - Abs(cHeadingAngle)) / m_sWheelTurningParams.HardTurnOnAngleThreshold;
+         Real fSpeedFactor = (sTurning.HardTurnOnAngleThreshold - Abs(cHeadingAngle)) / sTurning.HardTurnOnAngleThreshold;
          fSpeed1 = fBaseAngularWheelSpeed - fBaseAngularWheelSpeed * (1.0 - fSpeedFactor);
          fSpeed2 = fBaseAngularWheelSpeed + fBaseAngularWheelSpeed * (1.0 - fSpeedFactor);
          break;
       }
       case SWheelTurningParams::HARD_TURN: {
-         fSpeed1 = -m_sWheelTurningParams.MaxSpeed;
-         fSpeed2 =  m_sWheelTurningParams.MaxSpeed;
+         fSpeed1 = -sTurning.MaxSpeed;
+         fSpeed2 =  sTurning.MaxSpeed;
          break;
       }
    }
@@ -248,19 +297,29 @@ void FootBotTrack::SetWheelSpeedsFromVector(const CVector2& c_heading) {
    m_pcWheels->SetLinearVelocity(fLeftWheelSpeed, fRightWheelSpeed);
 }
 
+// soma f_delta a uma probabilidade e a mantém em [0,1]
+
+void FootBotTrack::AddProb(float& f_prob, Real f_delta) {
+   Real fProb = f_prob + f_delta;
+   m_psParams->State.ProbRange.TruncValue(fProb);
+   f_prob = fProb;
+}
+
 
 // Rest() faz com que o robõ "descanse" e carregue sua bateria (caso ele possua uma)
 
 void FootBotTrack::Rest() {
 
-   if(m_sStateData.TimeRested > m_sStateData.MinimumRestingTime &&
-      m_pcRNG->Uniform(m_sStateData.ProbRange) < m_sStateData.RestToExploreProb) {
+   const SStateParams& sParams = m_psParams->State;
+
+   if(m_sStateData.TimeRested > sParams.MinimumRestingTime &&
+      m_pcRNG->Uniform(sParams.ProbRange) < m_sStateData.RestToExploreProb) {
       m_pcLEDs->SetAllColors(CColor::GREEN);
       m_sStateData.State = SStateData::STATE_EXPLORING;
       m_sStateData.TimeRested = 0;
    }
    else {
-      ++m_sStateData.TimeRested;
+      Tick(m_sStateData.TimeRested);
 
       if(m_sStateData.TimeRested == 1) {
          m_pcRABA->SetData(0, LAST_EXPLORATION_NONE);
@@ -273,17 +332,13 @@ void FootBotTrack::Rest() {
       for(size_t i = 0; i < tPackets.size(); ++i) {
          switch(tPackets[i].Data[0]) {
             case LAST_EXPLORATION_SUCCESSFUL: {
-               m_sStateData.RestToExploreProb += m_sStateData.SocialRuleRestToExploreDeltaProb;
-               m_sStateData.ProbRange.TruncValue(m_sStateData.RestToExploreProb);
-               m_sStateData.ExploreToRestProb -= m_sStateData.SocialRuleExploreToRestDeltaProb;
-               m_sStateData.ProbRange.TruncValue(m_sStateData.ExploreToRestProb);
+               AddProb(m_sStateData.RestToExploreProb, sParams.SocialRuleRestToExploreDeltaProb);
+               AddProb(m_sStateData.ExploreToRestProb, -sParams.SocialRuleExploreToRestDeltaProb);
                break;
             }
             case LAST_EXPLORATION_UNSUCCESSFUL: {
-               m_sStateData.ExploreToRestProb += m_sStateData.SocialRuleExploreToRestDeltaProb;
-               m_sStateData.ProbRange.TruncValue(m_sStateData.ExploreToRestProb);
-               m_sStateData.RestToExploreProb -= m_sStateData.SocialRuleRestToExploreDeltaProb;
-               m_sStateData.ProbRange.TruncValue(m_sStateData.RestToExploreProb);
+               AddProb(m_sStateData.ExploreToRestProb, sParams.SocialRuleExploreToRestDeltaProb);
+               AddProb(m_sStateData.RestToExploreProb, -sParams.SocialRuleRestToExploreDeltaProb);
                break;
             }
          }
@@ -297,29 +352,26 @@ void FootBotTrack::Rest() {
 
 void FootBotTrack::Explore() {
 
+   const SStateParams& sParams = m_psParams->State;
    bool bFoundTarget(false);
 
-   if(m_Alvo.AlvoSpotted) {
+   if(m_sStateData.AlvoSpotted) {
 
-      m_sStateData.ExploreToRestProb -= m_sStateData.FoodRuleExploreToRestDeltaProb;
-      m_sStateData.ProbRange.TruncValue(m_sStateData.ExploreToRestProb);
-      m_sStateData.RestToExploreProb += m_sStateData.FoodRuleRestToExploreDeltaProb;
-      m_sStateData.ProbRange.TruncValue(m_sStateData.RestToExploreProb);
-      m_eLastExplorationResult = LAST_EXPLORATION_SUCCESSFUL;
+      AddProb(m_sStateData.ExploreToRestProb, -sParams.FoodRuleExploreToRestDeltaProb);
+      AddProb(m_sStateData.RestToExploreProb, sParams.FoodRuleRestToExploreDeltaProb);
+      m_sStateData.LastExplorationResult = LAST_EXPLORATION_SUCCESSFUL;
       bFoundTarget = true;
    }
 
-   else if(m_sStateData.TimeExploringUnsuccessfully > m_sStateData.MinimumUnsuccessfulExploreTime) {
-      if (m_pcRNG->Uniform(m_sStateData.ProbRange) < m_sStateData.ExploreToRestProb) {
-         m_eLastExplorationResult = LAST_EXPLORATION_UNSUCCESSFUL;
+   else if(m_sStateData.TimeExploringUnsuccessfully > sParams.MinimumUnsuccessfulExploreTime) {
+      if (m_pcRNG->Uniform(sParams.ProbRange) < m_sStateData.ExploreToRestProb) {
+         m_sStateData.LastExplorationResult = LAST_EXPLORATION_UNSUCCESSFUL;
          bFoundTarget = true;
       }
       else {
 
-         m_sStateData.ExploreToRestProb += m_sStateData.FoodRuleExploreToRestDeltaProb;
-         m_sStateData.ProbRange.TruncValue(m_sStateData.ExploreToRestProb);
-         m_sStateData.RestToExploreProb -= m_sStateData.FoodRuleRestToExploreDeltaProb;
-         m_sStateData.ProbRange.TruncValue(m_sStateData.RestToExploreProb);
+         AddProb(m_sStateData.ExploreToRestProb, sParams.FoodRuleExploreToRestDeltaProb);
+         AddProb(m_sStateData.RestToExploreProb, -sParams.FoodRuleRestToExploreDeltaProb);
       }
    }
 
@@ -332,27 +384,32 @@ void FootBotTrack::Explore() {
    }
    else {
 
-      ++m_sStateData.TimeExploringUnsuccessfully;
+      Tick(m_sStateData.TimeExploringUnsuccessfully);
       UpdateState();
       bool bCollision;
       CVector2 cDiffusion = DiffusionVector(bCollision);
       if(bCollision) {
 
-         m_sStateData.ExploreToRestProb += m_sStateData.CollisionRuleExploreToRestDeltaProb;
-         m_sStateData.ProbRange.TruncValue(m_sStateData.ExploreToRestProb);
-         m_sStateData.RestToExploreProb -= m_sStateData.CollisionRuleExploreToRestDeltaProb;
-         m_sStateData.ProbRange.TruncValue(m_sStateData.RestToExploreProb);
+         AddProb(m_sStateData.ExploreToRestProb, sParams.CollisionRuleExploreToRestDeltaProb);
+         AddProb(m_sStateData.RestToExploreProb, -sParams.CollisionRuleExploreToRestDeltaProb);
       }
 
+      Real fMaxSpeed = m_psParams->WheelTurning.MaxSpeed;
       if(m_sStateData.InNest) {
 
          SetWheelSpeedsFromVector(
-            m_sWheelTurningParams.MaxSpeed * cDiffusion -
-            m_sWheelTurningParams.MaxSpeed * 0.25f * CalculateVectorToLight());
+            fMaxSpeed * cDiffusion -
+            fMaxSpeed * 0.25f * CalculateVectorToLight());
+      }
+      else if(! bCollision) {
+
+         /* desvio das áreas visitadas recentemente (zero se bias = 0) */
+         CVector2 cBias(m_sStateData.CoverageBiasX, m_sStateData.CoverageBiasY);
+         SetWheelSpeedsFromVector(fMaxSpeed * (cDiffusion + cBias));
       }
       else {
 
-         SetWheelSpeedsFromVector(m_sWheelTurningParams.MaxSpeed * cDiffusion);
+         SetWheelSpeedsFromVector(fMaxSpeed * cDiffusion);
       }
    }
 }
@@ -361,17 +418,17 @@ void FootBotTrack::Explore() {
 void FootBotTrack::FoundTarget() {
    UpdateState();
    if(m_sStateData.InNest) {
-      if(m_sStateData.TimeSearchingForPlaceInNest > m_sStateData.MinimumSearchForPlaceInNestTime) {
+      if(m_sStateData.TimeSearchingForPlaceInNest > m_psParams->State.MinimumSearchForPlaceInNestTime) {
          m_pcWheels->SetLinearVelocity(0.0f, 0.0f);
-         m_pcRABA->SetData(0, m_eLastExplorationResult);
+         m_pcRABA->SetData(0, m_sStateData.LastExplorationResult);
          m_pcLEDs->SetAllColors(CColor::RED);
          m_sStateData.State = SStateData::STATE_RESTING;
          m_sStateData.TimeSearchingForPlaceInNest = 0;
-         m_eLastExplorationResult = LAST_EXPLORATION_NONE;
+         m_sStateData.LastExplorationResult = LAST_EXPLORATION_NONE;
          return;
       }
       else {
-         ++m_sStateData.TimeSearchingForPlaceInNest;
+         Tick(m_sStateData.TimeSearchingForPlaceInNest);
       }
    }
    else {
@@ -18,15 +18,6 @@ class FootBotTrack : public CCI_Controller {
 public:
 
 
-   struct Alvo {
-      bool AlvoSpotted;      // alvo encontrado
-      size_t AlvoID;        // ID do alvo único
-      size_t TotalAlvos;    // total de alvos encontrados pelo agente -> máximo é setado para '1'
-
-      Alvo();
-      void Reset();
-   };
-
    struct SDiffusionParams {
 
       Real Delta;
@@ -51,7 +42,7 @@ public:
          NO_TURN = 0, // go straight
          SOFT_TURN,   // both wheels are turning forwards, but at different speeds
          HARD_TURN    // wheels are turning with opposite speeds
-      } TurningMechanism;
+      };
       /*
        * Angular thresholds to change turning state.
        */
@@ -64,35 +55,65 @@ public:
       void Init(TConfigurationNode& t_tree);
    };
 
+   // probabilidades iniciais, deltas das regras e tempos mínimos de <state>
 
-   struct SStateData {
-      enum EState {
-         STATE_RESTING = 0,
-         STATE_EXPLORING,
-         STATE_RETURN_TO_NEST
-      } State;
-
-      bool InNest;
-
+   struct SStateParams {
       Real InitialRestToExploreProb;
-      Real RestToExploreProb;
       Real InitialExploreToRestProb;
-      Real ExploreToRestProb;
       CRange<Real> ProbRange;
       Real FoodRuleExploreToRestDeltaProb;
       Real FoodRuleRestToExploreDeltaProb;
       Real CollisionRuleExploreToRestDeltaProb;
       Real SocialRuleRestToExploreDeltaProb;
       Real SocialRuleExploreToRestDeltaProb;
-      size_t MinimumRestingTime;
-      size_t TimeRested;
-      size_t MinimumUnsuccessfulExploreTime;
-      size_t TimeExploringUnsuccessfully;
-      size_t MinimumSearchForPlaceInNestTime;
-      size_t TimeSearchingForPlaceInNest;
-      SStateData();
+      UInt16 MinimumRestingTime;
+      UInt16 MinimumUnsuccessfulExploreTime;
+      UInt16 MinimumSearchForPlaceInNestTime;
+      SStateParams();
       void Init(TConfigurationNode& t_node);
-      void Reset();
+   };
+
+   /*
+    * Parâmetros imutáveis (flyweight): todos os robôs com a mesma
+    * configuração apontam para a mesma instância, criada por Intern().
+    */
+   struct SSharedParams {
+      SDiffusionParams Diffusion;
+      SWheelTurningParams WheelTurning;
+      SStateParams State;
+
+      bool operator==(const SSharedParams& s_other) const;
+
+      /* devolve a instância compartilhada igual a s_params (não é thread-safe, chamar em Init()) */
+      static const SSharedParams* Intern(const SSharedParams& s_params);
+   };
+
+   /*
+    * Estado mutável de cada robô, compactado: probabilidades em float,
+    * contadores de 16 bits (saturados) e os enums/flags em um bitfield.
+    */
+   struct SStateData {
+      enum EState {
+         STATE_RESTING = 0,
+         STATE_EXPLORING,
+         STATE_RETURN_TO_NEST
+      };
+
+      float RestToExploreProb;
+      float ExploreToRestProb;
+      UInt32 AlvoID;                       // ID do alvo único (índice em items)
+      float CoverageBiasX;                 // desvio de cobertura, no referencial do robô
+      float CoverageBiasY;
+      UInt16 TimeRested;
+      UInt16 TimeExploringUnsuccessfully;
+      UInt16 TimeSearchingForPlaceInNest;
+      UInt8 State : 2;                     // EState
+      UInt8 TurningMechanism : 2;          // SWheelTurningParams::ETurningMechanism
+      UInt8 LastExplorationResult : 2;     // ELastExplorationResult
+      UInt8 InNest : 1;
+      UInt8 AlvoSpotted : 1;               // alvo encontrado
+
+      void Reset(const SStateParams& s_params);
    };
 
 public:
@@ -118,8 +139,25 @@ public:
    }
 
 
-   inline Alvo& GetInfoAlvo() {
-      return m_Alvo;
+   inline bool IsAlvoSpotted() const {
+      return m_sStateData.AlvoSpotted;
+   }
+
+   inline UInt32 GetAlvoID() const {
+      return m_sStateData.AlvoID;
+   }
+
+   // chamado pelas loop functions quando o robô passa sobre o alvo
+   inline void SpotAlvo(UInt32 un_alvo_id) {
+      m_sStateData.AlvoSpotted = true;
+      m_sStateData.AlvoID = un_alvo_id;
+   }
+
+   // desvio opcional, no referencial do robô, para longe das áreas visitadas
+   // recentemente; dado pelas loop functions a partir do mapa de cobertura
+   inline void SetCoverageBias(const CVector2& c_bias) {
+      m_sStateData.CoverageBiasX = c_bias.GetX();
+      m_sStateData.CoverageBiasY = c_bias.GetY();
    }
 
 private:
@@ -131,6 +169,7 @@ private:
    void Rest();
    void Explore();
    void FoundTarget();
+   void AddProb(float& f_prob, Real f_delta);
 
 private:
 
@@ -158,14 +197,12 @@ private:
       LAST_EXPLORATION_NONE = 0,    // nothing to report
       LAST_EXPLORATION_SUCCESSFUL,  // the last exploration resulted in a food item found
       LAST_EXPLORATION_UNSUCCESSFUL // no food found in the last exploration
-   } m_eLastExplorationResult;
+   };
 
+   /* Shared diffusion, turning and state parameters */
+   const SSharedParams* m_psParams;
+   /* Per-robot state */
    SStateData m_sStateData;
-   /* The turning parameters */
-   SWheelTurningParams m_sWheelTurningParams;
-   /* The diffusion parameters */
-   SDiffusionParams m_sDiffusionParams;
-   Alvo m_Alvo;
 
 };
 
@@ -0,0 +1,139 @@
+#include "coverage_grid.h"
+#include <algorithm>
+#include <cmath>
+
+const UInt32 CCoverageGrid::NO_CELL;
+const UInt32 CCoverageGrid::MAX_COUNT;
+
+CCoverageGrid::CCoverageGrid() :
+   m_fInvCellSize(1.0f),
+   m_unCellsX(0),
+   m_unCellsY(0),
+   m_unCells(0),
+   m_unCovered(0),
+   m_unEntries(0),
+   m_unRevisits(0),
+   m_unCoarseFactor(0),
+   m_unCoarseX(0),
+   m_unCoarseY(0),
+   m_fDecayRate(0.0f) {}
+
+
+void CCoverageGrid::Init(const CVector2& c_min, const CVector2& c_max, Real f_cell_size,
+                         UInt32 un_coarse_factor, UInt32 un_half_life) {
+   m_cMin = c_min;
+   m_cMax = c_max;
+   m_fInvCellSize = 1.0f / f_cell_size;
+   m_unCellsX = std::max<SInt32>(1, static_cast<SInt32>(std::ceil((c_max.GetX() - c_min.GetX()) * m_fInvCellSize)));
+   m_unCellsY = std::max<SInt32>(1, static_cast<SInt32>(std::ceil((c_max.GetY() - c_min.GetY()) * m_fInvCellSize)));
+   m_unCells = m_unCellsX * m_unCellsY;
+   m_vecCounts.assign((m_unCells + 1) / 2, 0);
+   m_unCoarseFactor = un_coarse_factor;
+   if(m_unCoarseFactor > 0) {
+      m_unCoarseX = (m_unCellsX + m_unCoarseFactor - 1) / m_unCoarseFactor;
+      m_unCoarseY = (m_unCellsY + m_unCoarseFactor - 1) / m_unCoarseFactor;
+      /* recência * 2^(-dt / meia-vida) = recência * exp(-dt * taxa) */
+      m_fDecayRate = un_half_life > 0 ? std::log(2.0f) / un_half_life : 0.0f;
+      SCoarseCell sEmpty = { 0.0f, 0 };
+      m_vecCoarse.assign(m_unCoarseX * m_unCoarseY, sEmpty);
+   }
+   else {
+      m_vecCoarse.clear();
+   }
+   Reset();
+}
+
+
+void CCoverageGrid::Reset() {
+   std::fill(m_vecCounts.begin(), m_vecCounts.end(), 0);
+   std::fill(m_vecLastCell.begin(), m_vecLastCell.end(), NO_CELL);
+   for(size_t i = 0; i < m_vecCoarse.size(); ++i) {
+      m_vecCoarse[i].Recency = 0.0f;
+      m_vecCoarse[i].Clock = 0;
+   }
+   m_unCovered = 0;
+   m_unEntries = 0;
+   m_unRevisits = 0;
+}
+
+
+void CCoverageGrid::Update(size_t un_robot, const CVector2& c_position, UInt32 un_clock) {
+   /* o vetor só cresce no primeiro passo com mais robôs */
+   if(un_robot >= m_vecLastCell.size()) {
+      m_vecLastCell.resize(un_robot + 1, NO_CELL);
+   }
+   UInt32& unLastCell = m_vecLastCell[un_robot];
+   if(m_unCells == 0 || ! Contains(c_position)) {
+      unLastCell = NO_CELL;
+      return;
+   }
+   UInt32 unCell = CellIndex(c_position);
+   if(unCell == unLastCell) return;
+   unLastCell = unCell;
+   /* entrou numa célula nova para ele */
+   ++m_unEntries;
+   UInt32 unCount = GetCount(unCell);
+   if(unCount == 0) ++m_unCovered;
+   else ++m_unRevisits;
+   if(unCount < MAX_COUNT) SetCount(unCell, unCount + 1);
+   if(m_unCoarseFactor > 0) {
+      UInt32 unX = (unCell % m_unCellsX) / m_unCoarseFactor;
+      UInt32 unY = (unCell / m_unCellsX) / m_unCoarseFactor;
+      SCoarseCell& sCoarse = m_vecCoarse[unY * m_unCoarseX + unX];
+      sCoarse.Recency = CoarseRecency(unX, unY, un_clock) + 1.0f;
+      sCoarse.Clock = un_clock;
+   }
+}
+
+
+UInt32 CCoverageGrid::GetVisitCount(const CVector2& c_position) const {
+   if(m_unCells == 0 || ! Contains(c_position)) return 0;
+   return GetCount(CellIndex(c_position));
+}
+
+
+Real CCoverageGrid::CoarseRecency(SInt32 n_x, SInt32 n_y, UInt32 un_clock) const {
+   const SCoarseCell& sCoarse = m_vecCoarse[n_y * m_unCoarseX + n_x];
+   if(sCoarse.Recency == 0.0f) return 0.0f;
+   return sCoarse.Recency * std::exp(-m_fDecayRate * (un_clock - sCoarse.Clock));
+}
+
+
+Real CCoverageGrid::CoarseDerivative(SInt32 n_x, SInt32 n_y, SInt32 n_dx, SInt32 n_dy,
+                                     UInt32 un_clock) const {
+   /* diferença central no interior; na borda, unilateral para dentro */
+   bool bBefore = n_x - n_dx >= 0 && n_y - n_dy >= 0;
+   bool bAfter  = n_x + n_dx < static_cast<SInt32>(m_unCoarseX) &&
+                  n_y + n_dy < static_cast<SInt32>(m_unCoarseY);
+   if(bBefore && bAfter) {
+      return 0.5f * (CoarseRecency(n_x + n_dx, n_y + n_dy, un_clock) -
+                     CoarseRecency(n_x - n_dx, n_y - n_dy, un_clock));
+   }
+   if(bAfter) {
+      return CoarseRecency(n_x + n_dx, n_y + n_dy, un_clock) - CoarseRecency(n_x, n_y, un_clock);
+   }
+   if(bBefore) {
+      return CoarseRecency(n_x, n_y, un_clock) - CoarseRecency(n_x - n_dx, n_y - n_dy, un_clock);
+   }
+   return 0.0f;
+}
+
+
+Real CCoverageGrid::GetRecency(const CVector2& c_position, UInt32 un_clock) const {
+   if(m_unCoarseFactor == 0 || ! Contains(c_position)) return 0.0f;
+   UInt32 unCell = CellIndex(c_position);
+   return CoarseRecency((unCell % m_unCellsX) / m_unCoarseFactor,
+                        (unCell / m_unCellsX) / m_unCoarseFactor,
+                        un_clock);
+}
+
+
+CVector2 CCoverageGrid::GetRecencyGradient(const CVector2& c_position, UInt32 un_clock) const {
+   if(m_unCoarseFactor == 0 || ! Contains(c_position)) return CVector2();
+   UInt32 unCell = CellIndex(c_position);
+   SInt32 nX = (unCell % m_unCellsX) / m_unCoarseFactor;
+   SInt32 nY = (unCell / m_unCellsX) / m_unCoarseFactor;
+   /* fora da área não há recência: nada puxa os robôs para as bordas (o ninho fica em x < min) */
+   return CVector2(CoarseDerivative(nX, nY, 1, 0, un_clock),
+                   CoarseDerivative(nX, nY, 0, 1, un_clock));
+}
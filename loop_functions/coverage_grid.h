@@ -0,0 +1,127 @@
+#ifndef COVERAGE_GRID_H
+#define COVERAGE_GRID_H
+
+/*
+ * Mapa de cobertura da área de busca.
+ *
+ * Raster com 4 bits por célula (duas células por byte) contando as entradas
+ * de robôs na célula, saturado em 15; célula visitada = contagem diferente de
+ * zero. Cada robô guarda a última célula em que esteve, então a atualização
+ * do passo é O(robôs): só quem mudou de célula mexe no raster.
+ *
+ * Opcionalmente mantém uma cópia grosseira (coarse_factor x coarse_factor
+ * células por bloco) com a "recência" das visitas, que decai pela metade a
+ * cada half_life passos. O decaimento é preguiçoso: cada bloco guarda o
+ * valor e o passo da última visita, e o valor atual é calculado na consulta.
+ */
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+#include <argos3/core/utility/math/vector2.h>
+#include <vector>
+
+using namespace argos;
+
+class CCoverageGrid {
+
+public:
+
+   CCoverageGrid();
+
+   /*
+    * Define a área coberta e aloca o raster.
+    * un_coarse_factor = 0 desliga a cópia grosseira.
+    */
+   void Init(const CVector2& c_min, const CVector2& c_max, Real f_cell_size,
+             UInt32 un_coarse_factor, UInt32 un_half_life);
+
+   /* zera as contagens, mantendo o tamanho */
+   void Reset();
+
+   /* posição do robô un_robot no passo un_clock; fora da área não conta */
+   void Update(size_t un_robot, const CVector2& c_position, UInt32 un_clock);
+
+   /* fração das células já visitadas */
+   inline Real GetCoverage() const {
+      return m_unCells > 0 ? static_cast<Real>(m_unCovered) / m_unCells : 0.0f;
+   }
+
+   /* fração das entradas em células que já tinham sido visitadas */
+   inline Real GetRevisitRatio() const {
+      return m_unEntries > 0 ? static_cast<Real>(m_unRevisits) / m_unEntries : 0.0f;
+   }
+
+   /* entradas na célula de c_position (0 a 15, 0 fora da área) */
+   UInt32 GetVisitCount(const CVector2& c_position) const;
+
+   inline bool HasRecency() const {
+      return m_unCoarseFactor > 0;
+   }
+
+   /* recência decaída do bloco de c_position no passo un_clock (0 fora da área) */
+   Real GetRecency(const CVector2& c_position, UInt32 un_clock) const;
+
+   /* gradiente da recência em c_position, por diferenças entre blocos vizinhos
+    * (centrais no interior, unilaterais nos blocos da borda) */
+   CVector2 GetRecencyGradient(const CVector2& c_position, UInt32 un_clock) const;
+
+private:
+
+   /* um bloco da cópia grosseira */
+   struct SCoarseCell {
+      float Recency;
+      UInt32 Clock;
+   };
+
+   static const UInt32 NO_CELL = 0xFFFFFFFF;
+   static const UInt32 MAX_COUNT = 15;
+
+   inline bool Contains(const CVector2& c_position) const {
+      return c_position.GetX() >= m_cMin.GetX() && c_position.GetY() >= m_cMin.GetY() &&
+             c_position.GetX() <  m_cMax.GetX() && c_position.GetY() <  m_cMax.GetY();
+   }
+
+   inline UInt32 CellIndex(const CVector2& c_position) const {
+      UInt32 unX = Min<UInt32>(m_unCellsX - 1, static_cast<UInt32>((c_position.GetX() - m_cMin.GetX()) * m_fInvCellSize));
+      UInt32 unY = Min<UInt32>(m_unCellsY - 1, static_cast<UInt32>((c_position.GetY() - m_cMin.GetY()) * m_fInvCellSize));
+      return unY * m_unCellsX + unX;
+   }
+
+   inline UInt32 GetCount(UInt32 un_cell) const {
+      return (m_vecCounts[un_cell >> 1] >> ((un_cell & 1) << 2)) & 0x0F;
+   }
+
+   inline void SetCount(UInt32 un_cell, UInt32 un_count) {
+      UInt8& unByte = m_vecCounts[un_cell >> 1];
+      UInt32 unShift = (un_cell & 1) << 2;
+      unByte = static_cast<UInt8>((unByte & ~(0x0F << unShift)) | (un_count << unShift));
+   }
+
+   /* bloco (n_x, n_y) dentro da cópia grosseira */
+   Real CoarseRecency(SInt32 n_x, SInt32 n_y, UInt32 un_clock) const;
+
+   /* derivada da recência na direção (n_dx, n_dy) = (1, 0) ou (0, 1) */
+   Real CoarseDerivative(SInt32 n_x, SInt32 n_y, SInt32 n_dx, SInt32 n_dy, UInt32 un_clock) const;
+
+private:
+
+   CVector2 m_cMin, m_cMax;
+   Real m_fInvCellSize;
+   UInt32 m_unCellsX, m_unCellsY, m_unCells;
+
+   /* contagens de 4 bits, duas por byte */
+   std::vector<UInt8> m_vecCounts;
+   /* última célula de cada robô (NO_CELL fora da área) */
+   std::vector<UInt32> m_vecLastCell;
+
+   UInt32 m_unCovered;
+   UInt64 m_unEntries;
+   UInt64 m_unRevisits;
+
+   /* cópia grosseira */
+   UInt32 m_unCoarseFactor;
+   UInt32 m_unCoarseX, m_unCoarseY;
+   Real m_fDecayRate;
+   std::vector<SCoarseCell> m_vecCoarse;
+};
+
+#endif
@@ -0,0 +1,157 @@
+/*
+ * Testes do mapa de cobertura: contagens de 4 bits empacotadas, cobertura,
+ * revisitas, decaimento preguiçoso da recência e gradiente nas bordas.
+ */
+
+#include "coverage_grid.h"
+#include <testing/unit_test.h>
+#include <cmath>
+#include <iostream>
+
+static bool Near(Real f_value, Real f_expected) {
+   return std::fabs(f_value - f_expected) < 1e-4;
+}
+
+/*
+ * Mesma área do swarm_tracking.argos depois do corte no ninho: x em [-1, 4),
+ * y em [-4, 4), células de 0.1 m (50 x 80) e blocos de 8 x 8 células.
+ */
+static void InitGrid(CCoverageGrid& c_grid) {
+   c_grid.Init(CVector2(-1.0f, -4.0f), CVector2(4.0f, 4.0f), 0.1f, 8, 100);
+}
+
+/* centro da célula (n_x, n_y) */
+static CVector2 Cell(SInt32 n_x, SInt32 n_y) {
+   return CVector2(-1.0f + 0.1f * n_x + 0.05f, -4.0f + 0.1f * n_y + 0.05f);
+}
+
+/* centro do bloco (n_x, n_y) da cópia grosseira */
+static CVector2 Block(SInt32 n_x, SInt32 n_y) {
+   return CVector2(-1.0f + 0.8f * n_x + 0.4f, -4.0f + 0.8f * n_y + 0.4f);
+}
+
+/****************************************/
+/****************************************/
+
+static void TestCoverageAndRevisits() {
+   CCoverageGrid cGrid;
+   InitGrid(cGrid);
+   CHECK(cGrid.GetCoverage() == 0.0f);
+   CHECK(cGrid.GetRevisitRatio() == 0.0f);
+   /* o robô 1 segue o caminho do robô 0: 50 células novas, 50 revisitas */
+   for(UInt32 t = 0; t < 50; ++t) {
+      cGrid.Update(0, Cell(t, 40), t);
+      cGrid.Update(1, Cell(t, 40), t);
+   }
+   CHECK(Near(cGrid.GetCoverage(), 50.0f / 4000.0f));
+   CHECK(Near(cGrid.GetRevisitRatio(), 0.5f));
+   CHECK(cGrid.GetVisitCount(Cell(10, 40)) == 2);
+   CHECK(cGrid.GetVisitCount(Cell(10, 41)) == 0);
+   /* ficar na mesma célula não é uma nova entrada */
+   cGrid.Update(0, Cell(49, 40), 50);
+   cGrid.Update(0, Cell(49, 40), 51);
+   CHECK(cGrid.GetVisitCount(Cell(49, 40)) == 2);
+   CHECK(Near(cGrid.GetRevisitRatio(), 0.5f));
+   /* fora da área não conta, e voltar conta como entrada */
+   cGrid.Update(0, CVector2(-3.0f, 0.0f), 52);
+   CHECK(cGrid.GetVisitCount(CVector2(-3.0f, 0.0f)) == 0);
+   CHECK(Near(cGrid.GetCoverage(), 50.0f / 4000.0f));
+   cGrid.Update(0, Cell(49, 40), 53);
+   CHECK(cGrid.GetVisitCount(Cell(49, 40)) == 3);
+   /* Reset zera tudo, inclusive a última célula de cada robô */
+   cGrid.Reset();
+   CHECK(cGrid.GetCoverage() == 0.0f);
+   CHECK(cGrid.GetRevisitRatio() == 0.0f);
+   CHECK(cGrid.GetVisitCount(Cell(10, 40)) == 0);
+   cGrid.Update(0, Cell(49, 40), 0);
+   CHECK(cGrid.GetVisitCount(Cell(49, 40)) == 1);
+}
+
+
+static void TestPacking() {
+   CCoverageGrid cGrid;
+   InitGrid(cGrid);
+   /* células 3010 e 3011 dividem um byte */
+   cGrid.Update(0, Cell(10, 60), 0);
+   CHECK(cGrid.GetVisitCount(Cell(10, 60)) == 1);
+   CHECK(cGrid.GetVisitCount(Cell(11, 60)) == 0);
+   CHECK(cGrid.GetVisitCount(Cell(9, 60)) == 0);
+   /* a vizinha satura em 15 sem mexer na outra metade do byte */
+   for(UInt32 t = 0; t < 40; ++t) {
+      cGrid.Update(1, Cell(11, 60 + (t % 2)), t);
+   }
+   CHECK(cGrid.GetVisitCount(Cell(11, 60)) == 15);
+   CHECK(cGrid.GetVisitCount(Cell(11, 61)) == 15);
+   CHECK(cGrid.GetVisitCount(Cell(10, 60)) == 1);
+   CHECK(cGrid.GetVisitCount(Cell(12, 60)) == 0);
+   /* a saturação não muda a cobertura nem a contagem de revisitas */
+   CHECK(Near(cGrid.GetCoverage(), 3.0f / 4000.0f));
+   CHECK(Near(cGrid.GetRevisitRatio(), 38.0f / 41.0f));
+}
+
+
+static void TestRecency() {
+   CCoverageGrid cGrid;
+   InitGrid(cGrid);
+   CHECK(cGrid.HasRecency());
+   CHECK(cGrid.GetRecency(Block(2, 5), 0) == 0.0f);
+   cGrid.Update(0, Block(2, 5), 0);
+   CHECK(Near(cGrid.GetRecency(Block(2, 5), 0), 1.0f));
+   /* cai pela metade a cada half_life passos */
+   CHECK(Near(cGrid.GetRecency(Block(2, 5), 100), 0.5f));
+   CHECK(Near(cGrid.GetRecency(Block(2, 5), 200), 0.25f));
+   /* nova entrada no mesmo bloco soma ao valor decaído */
+   cGrid.Update(1, Block(2, 5) + CVector2(0.1f, 0.0f), 100);
+   CHECK(Near(cGrid.GetRecency(Block(2, 5), 100), 1.5f));
+   CHECK(Near(cGrid.GetRecency(Block(2, 5), 200), 0.75f));
+   CHECK(cGrid.GetRecency(Block(3, 5), 100) == 0.0f);
+   /* sem cópia grosseira não há recência */
+   CCoverageGrid cFlat;
+   cFlat.Init(CVector2(-1.0f, -4.0f), CVector2(4.0f, 4.0f), 0.1f, 0, 100);
+   cFlat.Update(0, Block(2, 5), 0);
+   CHECK(! cFlat.HasRecency());
+   CHECK(cFlat.GetRecency(Block(2, 5), 0) == 0.0f);
+   CHECK(cFlat.GetRecencyGradient(Block(2, 5), 0).GetX() == 0.0f);
+}
+
+
+static void TestGradient() {
+   CCoverageGrid cGrid;
+   InitGrid(cGrid);
+   /* interior: diferença central */
+   cGrid.Update(0, Block(3, 5), 0);
+   CVector2 cGradient = cGrid.GetRecencyGradient(Block(2, 5), 0);
+   CHECK(Near(cGradient.GetX(), 0.5f));
+   CHECK(Near(cGradient.GetY(), 0.0f));
+   cGradient = cGrid.GetRecencyGradient(Block(3, 4), 0);
+   CHECK(Near(cGradient.GetX(), 0.0f));
+   CHECK(Near(cGradient.GetY(), 0.5f));
+   /*
+    * borda do ninho (x = -1): o bloco 0, mais visitado que o bloco 1, tem
+    * gradiente negativo, e o desvio (-gradiente) aponta para longe do ninho
+    */
+   for(UInt32 t = 0; t < 4; ++t) {
+      cGrid.Update(1, Block(0, 5) + CVector2(0.0f, 0.1f * (t % 2)), 0);
+   }
+   cGrid.Update(2, Block(1, 5), 0);
+   cGradient = cGrid.GetRecencyGradient(Block(0, 5), 0);
+   CHECK(Near(cGradient.GetX(), 1.0f - 4.0f));
+   /* borda de cima: unilateral para dentro */
+   cGrid.Update(3, Block(4, 9), 0);
+   cGradient = cGrid.GetRecencyGradient(Block(4, 9), 0);
+   CHECK(Near(cGradient.GetY(), 1.0f));
+   /* fora da área */
+   cGradient = cGrid.GetRecencyGradient(CVector2(-3.0f, 0.0f), 0);
+   CHECK(cGradient.GetX() == 0.0f && cGradient.GetY() == 0.0f);
+}
+
+/****************************************/
+/****************************************/
+
+int main() {
+   TestCoverageAndRevisits();
+   TestPacking();
+   TestRecency();
+   TestGradient();
+   return TestResult();
+}
@@ -10,8 +10,7 @@ CForagingQTUserFunctions::CForagingQTUserFunctions() {
 
 void CForagingQTUserFunctions::Draw(CFootBotEntity& c_entity) {
    FootBotTrack& cController = dynamic_cast<FootBotTrack&>(c_entity.GetControllableEntity().GetController());
-   FootBotTrack::Alvo& Alvo = cController.GetInfoAlvo();
-   if(Alvo.AlvoSpotted) {
+   if(cController.IsAlvoSpotted()) {
       DrawCylinder(
          CVector3(0.0f, 0.0f, 0.3f),
          CQuaternion(),
@@ -7,14 +7,8 @@
 // inicializa variáveis globais de : arena + informações do swarm
 
 CTrackingLoopFunctions::CTrackingLoopFunctions() :
-   m_cForagingArenaSideX(-0.9f, 1.7f),
-   m_cForagingArenaSideY(-1.7f, 1.7f),
    m_pcFloor(NULL),
-   m_pcRNG(NULL),
-   m_unCollectedFood(0),
-   m_nEnergy(0),
-   m_unEnergyPerFoodItem(1),
-   m_unEnergyPerWalkingRobot(1) {
+   m_pcRNG(NULL) {
 }
 
 // Inicializa o experimento
@@ -23,24 +17,16 @@ void CTrackingLoopFunctions::Init(TConfigurationNode& t_node) {
    try {
       TConfigurationNode& tForaging = GetNode(t_node, "foraging");
       m_pcFloor = &GetSpace().GetFloorEntity();
-      // numero de alvos
-      UInt32 unFoodItems;
-      GetNodeAttribute(tForaging, "items", unFoodItems);
-      GetNodeAttribute(tForaging, "radius", m_fFoodSquareRadius);
-      m_fFoodSquareRadius *= m_fFoodSquareRadius;
       // gerador de numeros aleatórios
       m_pcRNG = CRandom::CreateRNG("argos");
-      // distribuição dos alvos
-      for(UInt32 i = 0; i < unFoodItems; ++i) {
-         m_cFoodPos.push_back(
-            CVector2(m_pcRNG->Uniform(m_cForagingArenaSideX),
-                     m_pcRNG->Uniform(m_cForagingArenaSideY)));
-      }
-      GetNodeAttribute(tForaging, "output", m_strOutput);
-      m_cOutput.open(m_strOutput.c_str(), std::ios_base::trunc | std::ios_base::out);
-      m_cOutput << "# iteração\tprocurando\tdescanso\talvos_encontrados\tenergia" << std::endl;
-      GetNodeAttribute(tForaging, "energy_per_item", m_unEnergyPerFoodItem);
-      GetNodeAttribute(tForaging, "energy_per_walking_robot", m_unEnergyPerWalkingRobot);
+      // alvos, energia e arquivo de saída
+      m_cRules.Init(tForaging, m_pcRNG);
+      // mapa de cobertura do tamanho da arena
+      const CVector3& cCenter = GetSpace().GetArenaCenter();
+      const CVector3& cSize = GetSpace().GetArenaSize();
+      m_cRules.SetArena(CVector2(cCenter.GetX() - cSize.GetX() * 0.5f, cCenter.GetY() - cSize.GetY() * 0.5f),
+                        CVector2(cCenter.GetX() + cSize.GetX() * 0.5f, cCenter.GetY() + cSize.GetY() * 0.5f));
+      CollectFootBots();
    }
    catch(CARGoSException& ex) {
       THROW_ARGOSEXCEPTION_NESTED("Error parsing loop functions!", ex);
@@ -49,88 +35,55 @@ void CTrackingLoopFunctions::Init(TConfigurationNode& t_node) {
 
 
 void CTrackingLoopFunctions::Reset() {
-   m_unCollectedFood = 0;
-   m_nEnergy = 0;
-   m_cOutput.close();
-   m_cOutput.open(m_strOutput.c_str(), std::ios_base::trunc | std::ios_base::out);
-   m_cOutput << "# clock\twalking\tresting\tcollected_food\tenergy" << std::endl;
-   for(UInt32 i = 0; i < m_cFoodPos.size(); ++i) {
-      m_cFoodPos[i].Set(m_pcRNG->Uniform(m_cForagingArenaSideX),
-                        m_pcRNG->Uniform(m_cForagingArenaSideY));
-   }
+   m_cRules.Reset();
+   CollectFootBots();
 }
 
 
 void CTrackingLoopFunctions::Destroy() {
-   m_cOutput.close();
+   m_cRules.Destroy();
+   m_vecFootBots.clear();
 }
 
 
 CColor CTrackingLoopFunctions::GetFloorColor(const CVector2& c_position_on_plane) {
-   if(c_position_on_plane.GetX() < -1.0f) {
-      return CColor::GRAY50;
-   }
-   for(UInt32 i = 0; i < m_cFoodPos.size(); ++i) {
-      if((c_position_on_plane - m_cFoodPos[i]).SquareLength() < m_fFoodSquareRadius) {
-         return CColor::BLACK;
-      }
-   }
-   return CColor::WHITE;
+   return m_cRules.GetFloorColor(c_position_on_plane);
 }
 
 
-void CTrackingLoopFunctions::PreStep() {
-   // função que dita o funcionamento de encontro ao alvo
-   UInt32 unWalkingFBs = 0;
-   UInt32 unRestingFBs = 0;
-   // robô encontrou o alvo?
+// guarda entidade e controlador de cada foot-bot, para o PreStep não
+// percorrer o mapa de entidades nem fazer any_cast/dynamic_cast a cada passo
 
+void CTrackingLoopFunctions::CollectFootBots() {
+   m_vecFootBots.clear();
    CSpace::TMapPerType& m_cFootbots = GetSpace().GetEntitiesByType("foot-bot");
-
+   m_vecFootBots.reserve(m_cFootbots.size());
    for(CSpace::TMapPerType::iterator it = m_cFootbots.begin();it != m_cFootbots.end();it++) {
-      // acessa entidade foot-bot e controladores
-      CFootBotEntity& cFootBot = *any_cast<CFootBotEntity*>(it->second);
-      FootBotTrack& cController = dynamic_cast<FootBotTrack&>(cFootBot.GetControllableEntity().GetController());
-      // conta quantos robôs estão em quantos estados
-      if(! cController.IsResting()) unWalkingFBs++;
-      else unRestingFBs++;
-
-      // cPos -> posição do robô no plano 2D
-      CVector2 cPos;
-      cPos.Set(cFootBot.GetEmbodiedEntity().GetOriginAnchor().Position.GetX(),
-               cFootBot.GetEmbodiedEntity().GetOriginAnchor().Position.GetY());
-
-      // posição do alvo
-      FootBotTrack::Alvo& Alvo = cController.GetInfoAlvo();
-
-      if(Alvo.AlvoSpotted){
-        std::cout << cPos.GetX() << cPos.GetY();
-      }
+      SFootBot sFootBot;
+      sFootBot.Entity = any_cast<CFootBotEntity*>(it->second);
+      sFootBot.Controller = &dynamic_cast<FootBotTrack&>(sFootBot.Entity->GetControllableEntity().GetController());
+      m_vecFootBots.push_back(sFootBot);
+   }
+}
+
 
-      // alvo não foi encontrado
-      if(!Alvo.AlvoSpotted) {
-
-        // se x > -1.0 => robô esta fora da zona de descanso
-        if(cPos.GetX() > -1.0f) {
-           bool bDone = false;
-           for(size_t i = 0; i < m_cFoodPos.size() && !bDone; ++i) {
-              if((cPos - m_cFoodPos[i]).SquareLength() < m_fFoodSquareRadius) {
-                 m_cFoodPos[i].Set(100.0f, 100.f);
-                 Alvo.AlvoSpotted = true;
-                 Alvo.AlvoID = i;
-                 m_pcFloor->SetChanged();
-                 bDone = true;
-              }
-           }
-        }
+void CTrackingLoopFunctions::PreStep() {
+   UInt32 unClock = GetSpace().GetSimulationClock();
+   m_cRules.BeginStep();
+
+   for(size_t i = 0; i < m_vecFootBots.size(); ++i) {
+      // cPos -> posição do robô no plano 2D, cZ -> orientação no plano
+      const SAnchor& sAnchor = m_vecFootBots[i].Entity->GetEmbodiedEntity().GetOriginAnchor();
+      CVector2 cPos(sAnchor.Position.GetX(), sAnchor.Position.GetY());
+      CRadians cZ, cY, cX;
+      sAnchor.Orientation.ToEulerAngles(cZ, cY, cX);
+
+      // robô encontrou o alvo?
+      if(m_cRules.Visit(i, *m_vecFootBots[i].Controller, cPos, cZ, unClock)) {
+         m_pcFloor->SetChanged();
       }
    }
-   m_nEnergy -= unWalkingFBs * m_unEnergyPerWalkingRobot;
-   m_cOutput << GetSpace().GetSimulationClock() << "\t"
-             << unWalkingFBs << "\t"
-             << unRestingFBs << "\t"
-             << m_unCollectedFood << "\t"
-             << m_nEnergy << std::endl;
+   m_cRules.EndStep(unClock);
 }
 
 REGISTER_LOOP_FUNCTIONS(CTrackingLoopFunctions, "loop_functions")
@@ -1,10 +1,13 @@
 #ifndef FORAGING_LOOP_FUNCTIONS_H
 #define FORAGING_LOOP_FUNCTIONS_H
 
+#include "tracking_rules.h"
 #include <argos3/core/simulator/loop_functions.h>
 #include <argos3/core/simulator/entity/floor_entity.h>
 #include <argos3/core/utility/math/range.h>
 #include <argos3/core/utility/math/rng.h>
+#include <argos3/plugins/robots/foot-bot/simulator/footbot_entity.h>
+#include <vector>
 
 using namespace argos;
 
@@ -23,19 +26,23 @@ public:
 
 private:
 
-   Real m_fFoodSquareRadius;
-   CRange<Real> m_cForagingArenaSideX, m_cForagingArenaSideY;
-   std::vector<CVector2> m_cFoodPos;
+   /* foot-bot e seu controlador, resolvidos uma vez fora do passo */
+   struct SFootBot {
+      CFootBotEntity* Entity;
+      FootBotTrack* Controller;
+   };
+
+   void CollectFootBots();
+
+private:
+
    CFloorEntity* m_pcFloor;
    CRandom::CRNG* m_pcRNG;
 
-   std::string m_strOutput;
-   std::ofstream m_cOutput;
+   /* alvos, energia e saída (compartilhados com o motor substituto) */
+   CTrackingRules m_cRules;
 
-   UInt32 m_unCollectedFood;
-   SInt64 m_nEnergy;
-   UInt32 m_unEnergyPerFoodItem;
-   UInt32 m_unEnergyPerWalkingRobot;
+   std::vector<SFootBot> m_vecFootBots;
 };
 
 #endif
@@ -0,0 +1,200 @@
+#include "tracking_rules.h"
+#include <cstdio>
+
+const Real CTrackingRules::NEST_LIMIT_X = -1.0f;
+
+CTrackingRules::SStatistics::SStatistics() {
+   Reset();
+}
+
+void CTrackingRules::SStatistics::Reset() {
+   Walking = 0;
+   Resting = 0;
+   Detected = 0;
+   Energy = 0;
+   FirstDetection = -1;
+   WalkingSum = 0;
+   RestingSum = 0;
+}
+
+// inicializa variáveis globais da arena
+
+CTrackingRules::CTrackingRules() :
+   m_fFoodSquareRadius(0.0f),
+   m_cForagingArenaSideX(-0.9f, 1.7f),
+   m_cForagingArenaSideY(-1.7f, 1.7f),
+   m_pcRNG(NULL),
+   m_unEnergyPerFoodItem(1),
+   m_unEnergyPerWalkingRobot(1),
+   m_fCoverageCellSize(0.1f),
+   m_bCoverageBounds(false),
+   m_unCoverageCoarseFactor(8),
+   m_unCoverageHalfLife(600),
+   m_fCoverageBias(0.0f) {}
+
+
+void CTrackingRules::Init(TConfigurationNode& t_foraging, CRandom::CRNG* pc_rng,
+                          const std::string& str_output) {
+   m_pcRNG = pc_rng;
+   // numero de alvos
+   UInt32 unFoodItems;
+   GetNodeAttribute(t_foraging, "items", unFoodItems);
+   GetNodeAttribute(t_foraging, "radius", m_fFoodSquareRadius);
+   m_fFoodSquareRadius *= m_fFoodSquareRadius;
+   // distribuição dos alvos
+   m_cFoodPos.clear();
+   m_cFoodPos.reserve(unFoodItems);
+   for(UInt32 i = 0; i < unFoodItems; ++i) {
+      m_cFoodPos.push_back(
+         CVector2(m_pcRNG->Uniform(m_cForagingArenaSideX),
+                  m_pcRNG->Uniform(m_cForagingArenaSideY)));
+   }
+   GetNodeAttribute(t_foraging, "output", m_strOutput);
+   if(! str_output.empty()) {
+      m_strOutput = str_output;
+   }
+   GetNodeAttribute(t_foraging, "energy_per_item", m_unEnergyPerFoodItem);
+   GetNodeAttribute(t_foraging, "energy_per_walking_robot", m_unEnergyPerWalkingRobot);
+   // mapa de cobertura: tamanho da célula, área e desvio opcional do Explore
+   if(NodeExists(t_foraging, "coverage")) {
+      TConfigurationNode& tCoverage = GetNode(t_foraging, "coverage");
+      GetNodeAttributeOrDefault(tCoverage, "cell_size", m_fCoverageCellSize, m_fCoverageCellSize);
+      if(NodeAttributeExists(tCoverage, "min") && NodeAttributeExists(tCoverage, "max")) {
+         GetNodeAttribute(tCoverage, "min", m_cCoverageMin);
+         GetNodeAttribute(tCoverage, "max", m_cCoverageMax);
+         m_bCoverageBounds = true;
+      }
+      GetNodeAttributeOrDefault(tCoverage, "coarse_factor", m_unCoverageCoarseFactor, m_unCoverageCoarseFactor);
+      GetNodeAttributeOrDefault(tCoverage, "half_life", m_unCoverageHalfLife, m_unCoverageHalfLife);
+      GetNodeAttributeOrDefault(tCoverage, "bias", m_fCoverageBias, m_fCoverageBias);
+   }
+   m_sStatistics.Reset();
+   OpenOutput();
+}
+
+
+void CTrackingRules::SetArena(const CVector2& c_arena_min, const CVector2& c_arena_max) {
+   CVector2 cMin = m_bCoverageBounds ? m_cCoverageMin : c_arena_min;
+   CVector2 cMax = m_bCoverageBounds ? m_cCoverageMax : c_arena_max;
+   // só a área de busca: a zona de descanso fica de fora
+   cMin.SetX(Max<Real>(cMin.GetX(), NEST_LIMIT_X));
+   if(cMax.GetX() <= cMin.GetX() || cMax.GetY() <= cMin.GetY()) {
+      THROW_ARGOSEXCEPTION("Coverage area is empty outside the nest");
+   }
+   // a cópia grosseira só é mantida quando o desvio do Explore está ligado
+   m_cCoverage.Init(cMin, cMax, m_fCoverageCellSize,
+                    m_fCoverageBias > 0.0f ? m_unCoverageCoarseFactor : 0,
+                    m_unCoverageHalfLife);
+}
+
+
+void CTrackingRules::Reset() {
+   m_sStatistics.Reset();
+   m_cCoverage.Reset();
+   for(UInt32 i = 0; i < m_cFoodPos.size(); ++i) {
+      m_cFoodPos[i].Set(m_pcRNG->Uniform(m_cForagingArenaSideX),
+                        m_pcRNG->Uniform(m_cForagingArenaSideY));
+   }
+   OpenOutput();
+}
+
+
+void CTrackingRules::Destroy() {
+   m_cOutput.flush();
+   m_cOutput.close();
+}
+
+
+void CTrackingRules::OpenOutput() {
+   m_cOutput.flush();
+   m_cOutput.close();
+   m_cOutput.open(m_strOutput.c_str(), std::ios_base::trunc | std::ios_base::out);
+   m_cOutput << "# iteração\tprocurando\tdescanso\talvos_encontrados\tenergia\tcobertura\trevisitas" << std::endl;
+}
+
+
+bool CTrackingRules::IsOnTarget(const CVector2& c_position) const {
+   for(UInt32 i = 0; i < m_cFoodPos.size(); ++i) {
+      if((c_position - m_cFoodPos[i]).SquareLength() < m_fFoodSquareRadius) {
+         return true;
+      }
+   }
+   return false;
+}
+
+
+CColor CTrackingRules::GetFloorColor(const CVector2& c_position_on_plane) const {
+   if(IsInNest(c_position_on_plane)) {
+      return CColor::GRAY50;
+   }
+   if(IsOnTarget(c_position_on_plane)) {
+      return CColor::BLACK;
+   }
+   return CColor::WHITE;
+}
+
+
+void CTrackingRules::BeginStep() {
+   m_sStatistics.Walking = 0;
+   m_sStatistics.Resting = 0;
+}
+
+// função que dita o funcionamento de encontro ao alvo
+
+bool CTrackingRules::Visit(size_t un_robot, FootBotTrack& c_controller,
+                          const CVector2& c_position, const CRadians& c_orientation, UInt32 un_clock) {
+   // conta quantos robôs estão em quantos estados
+   if(! c_controller.IsResting()) m_sStatistics.Walking++;
+   else m_sStatistics.Resting++;
+   // cobertura: só quem mudou de célula altera o mapa
+   m_cCoverage.Update(un_robot, c_position, un_clock);
+   if(m_fCoverageBias > 0.0f) {
+      // desce o gradiente da recência, com comprimento no máximo igual a bias;
+      // escrito a cada passo mesmo fora da exploração, assim quem volta do
+      // descanso ou do ninho não usa o desvio da última vez que explorou
+      CVector2 cBias = -m_cCoverage.GetRecencyGradient(c_position, un_clock) * m_fCoverageBias;
+      if(cBias.SquareLength() > m_fCoverageBias * m_fCoverageBias) {
+         cBias.Normalize();
+         cBias *= m_fCoverageBias;
+      }
+      c_controller.SetCoverageBias(cBias.Rotate(-c_orientation));
+   }
+   // alvo não foi encontrado e o robô está fora da zona de descanso
+   if(c_controller.IsAlvoSpotted() || IsInNest(c_position)) {
+      return false;
+   }
+   for(size_t i = 0; i < m_cFoodPos.size(); ++i) {
+      if((c_position - m_cFoodPos[i]).SquareLength() < m_fFoodSquareRadius) {
+         m_cFoodPos[i].Set(100.0f, 100.f);
+         c_controller.SpotAlvo(i);
+         ++m_sStatistics.Detected;
+         if(m_sStatistics.FirstDetection < 0) {
+            m_sStatistics.FirstDetection = un_clock;
+         }
+         return true;
+      }
+   }
+   return false;
+}
+
+
+void CTrackingRules::EndStep(UInt32 un_clock) {
+   m_sStatistics.WalkingSum += m_sStatistics.Walking;
+   m_sStatistics.RestingSum += m_sStatistics.Resting;
+   m_sStatistics.Energy -= m_sStatistics.Walking * m_unEnergyPerWalkingRobot;
+   /* formatada na pilha; flush a cada OUTPUT_FLUSH_STEPS passos, assim uma
+    * execução interrompida perde no máximo esse tanto do fim do arquivo */
+   char pchLine[128];
+   int nLength = ::snprintf(pchLine, sizeof(pchLine), "%lu\t%lu\t%lu\t%lu\t%lld\t%.4f\t%.4f\n",
+                            static_cast<unsigned long>(un_clock),
+                            static_cast<unsigned long>(m_sStatistics.Walking),
+                            static_cast<unsigned long>(m_sStatistics.Resting),
+                            static_cast<unsigned long>(m_sStatistics.Detected),
+                            static_cast<long long>(m_sStatistics.Energy),
+                            static_cast<double>(m_cCoverage.GetCoverage()),
+                            static_cast<double>(m_cCoverage.GetRevisitRatio()));
+   m_cOutput.write(pchLine, nLength);
+   if(un_clock % OUTPUT_FLUSH_STEPS == 0) {
+      m_cOutput.flush();
+   }
+}
@@ -0,0 +1,125 @@
+#ifndef TRACKING_RULES_H
+#define TRACKING_RULES_H
+
+/*
+ * Regras do experimento: posição dos alvos, detecção, energia, mapa de cobertura
+ * e arquivo de saída.
+ * Usadas por CTrackingLoopFunctions (ARGoS) e pelo motor substituto, para que
+ * os dois motores e o benchmark executem exatamente o mesmo código de PreStep.
+ */
+
+#include "coverage_grid.h"
+#include <footbot_tracking/footbot_tracking.h>
+#include <argos3/core/utility/configuration/argos_configuration.h>
+#include <argos3/core/utility/datatypes/color.h>
+#include <argos3/core/utility/math/angles.h>
+#include <argos3/core/utility/math/range.h>
+#include <argos3/core/utility/math/rng.h>
+#include <argos3/core/utility/math/vector2.h>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace argos;
+
+class CTrackingRules {
+
+public:
+
+   struct SStatistics {
+      UInt32 Walking;          // robôs fora do descanso no último passo
+      UInt32 Resting;          // robôs descansando no último passo
+      UInt32 Detected;         // alvos encontrados até agora
+      SInt64 Energy;           // energia acumulada
+      SInt64 FirstDetection;   // passo do primeiro alvo encontrado, -1 se nenhum
+      UInt64 WalkingSum;       // soma de Walking em todos os passos
+      UInt64 RestingSum;       // soma de Resting em todos os passos
+
+      SStatistics();
+      void Reset();
+   };
+
+public:
+
+   CTrackingRules();
+
+   /* lê <foraging>, sorteia os alvos e abre a saída (str_output substitui o atributo "output") */
+   void Init(TConfigurationNode& t_foraging, CRandom::CRNG* pc_rng,
+             const std::string& str_output = "");
+   /*
+    * Dimensiona o mapa de cobertura a partir dos limites da arena (ou de
+    * min/max de <coverage>), sem a zona de descanso. Chamar depois de Init().
+    */
+   void SetArena(const CVector2& c_arena_min, const CVector2& c_arena_max);
+   void Reset();
+   void Destroy();
+
+   /* a zona de descanso (ninho) é x < NEST_LIMIT_X */
+   static const Real NEST_LIMIT_X;
+
+   inline bool IsInNest(const CVector2& c_position) const {
+      return c_position.GetX() < NEST_LIMIT_X;
+   }
+
+   bool IsOnTarget(const CVector2& c_position) const;
+
+   CColor GetFloorColor(const CVector2& c_position_on_plane) const;
+
+   /* passo: BeginStep(), Visit() para cada robô, EndStep() */
+   void BeginStep();
+   /*
+    * Conta o estado do robô un_robot, atualiza o mapa de cobertura e testa se
+    * ele encontrou um alvo (devolve true nesse caso). Com bias > 0 em
+    * <coverage>, também passa ao controlador o desvio para longe das áreas
+    * visitadas recentemente.
+    */
+   bool Visit(size_t un_robot, FootBotTrack& c_controller,
+              const CVector2& c_position, const CRadians& c_orientation, UInt32 un_clock);
+   /* atualiza a energia e escreve a linha do passo */
+   void EndStep(UInt32 un_clock);
+
+   inline size_t GetNumTargets() const {
+      return m_cFoodPos.size();
+   }
+
+   inline const SStatistics& GetStatistics() const {
+      return m_sStatistics;
+   }
+
+   inline const CCoverageGrid& GetCoverage() const {
+      return m_cCoverage;
+   }
+
+private:
+
+   void OpenOutput();
+
+   /* passos entre flushes do arquivo de saída */
+   static const UInt32 OUTPUT_FLUSH_STEPS = 100;
+
+private:
+
+   Real m_fFoodSquareRadius;
+   CRange<Real> m_cForagingArenaSideX, m_cForagingArenaSideY;
+   std::vector<CVector2> m_cFoodPos;
+   CRandom::CRNG* m_pcRNG;
+
+   std::string m_strOutput;
+   std::ofstream m_cOutput;
+
+   UInt32 m_unEnergyPerFoodItem;
+   UInt32 m_unEnergyPerWalkingRobot;
+
+   SStatistics m_sStatistics;
+
+   /* mapa de cobertura, configurado por <coverage> (opcional) */
+   CCoverageGrid m_cCoverage;
+   Real m_fCoverageCellSize;
+   bool m_bCoverageBounds;
+   CVector2 m_cCoverageMin, m_cCoverageMax;
+   UInt32 m_unCoverageCoarseFactor;
+   UInt32 m_unCoverageHalfLife;
+   Real m_fCoverageBias;
+};
+
+#endif
@@ -0,0 +1,58 @@
+#include "evaluation_cache.h"
+#include <argos3/core/utility/configuration/argos_exception.h>
+#include <sstream>
+
+// formato: hash(hex) semente passos energia_por_robô descrição
+
+void CEvaluationCache::Open(const std::string& str_file) {
+   m_mapResults.clear();
+   std::ifstream cInput(str_file.c_str());
+   std::string strLine;
+   while(std::getline(cInput, strLine)) {
+      if(strLine.empty() || strLine[0] == '#') continue;
+      std::istringstream cRow(strLine);
+      UInt64 unHash;
+      UInt32 unSeed;
+      SResult sResult;
+      if(cRow >> std::hex >> unHash >> std::dec >> unSeed >> sResult.TicksToDetection >> sResult.EnergyPerRobot) {
+         m_mapResults[std::make_pair(unHash, unSeed)] = sResult;
+      }
+   }
+   cInput.close();
+   m_cFile.open(str_file.c_str(), std::ios_base::app | std::ios_base::out);
+   if(! m_cFile) {
+      THROW_ARGOSEXCEPTION("Can't open evaluation cache \"" << str_file << "\"");
+   }
+   /* 17 algarismos: o valor relido é idêntico ao da memória, e uma otimização
+      retomada ordena os candidatos exatamente como a ininterrupta */
+   m_cFile.precision(17);
+}
+
+
+bool CEvaluationCache::Find(UInt64 un_hash, UInt32 un_seed, SResult& s_result) const {
+   TResultMap::const_iterator it = m_mapResults.find(std::make_pair(un_hash, un_seed));
+   if(it == m_mapResults.end()) return false;
+   s_result = it->second;
+   return true;
+}
+
+
+void CEvaluationCache::Store(UInt64 un_hash, UInt32 un_seed, const SResult& s_result,
+                             const std::string& str_description) {
+   m_mapResults[std::make_pair(un_hash, un_seed)] = s_result;
+   m_cFile << std::hex << un_hash << std::dec << "\t"
+           << un_seed << "\t"
+           << s_result.TicksToDetection << "\t"
+           << s_result.EnergyPerRobot << "\t"
+           << str_description << std::endl;
+}
+
+
+UInt64 CEvaluationCache::Hash(const std::string& str_text) {
+   UInt64 unHash = 14695981039346656037ULL;
+   for(size_t i = 0; i < str_text.size(); ++i) {
+      unHash ^= static_cast<unsigned char>(str_text[i]);
+      unHash *= 1099511628211ULL;
+   }
+   return unHash;
+}
@@ -0,0 +1,52 @@
+#ifndef EVALUATION_CACHE_H
+#define EVALUATION_CACHE_H
+
+/*
+ * Cache persistente de avaliações, indexado por (hash dos parâmetros, semente).
+ * Cada avaliação concluída é acrescentada ao arquivo imediatamente, então uma
+ * otimização interrompida pode ser retomada sem repetir nenhuma simulação.
+ */
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+#include <fstream>
+#include <map>
+#include <string>
+#include <utility>
+
+using namespace argos;
+
+class CEvaluationCache {
+
+public:
+
+   struct SResult {
+      Real TicksToDetection;   // passo do primeiro alvo (ou a duração, se nenhum)
+      Real EnergyPerRobot;     // energia final por robô (negativa, como nas loop functions)
+   };
+
+public:
+
+   /* carrega as entradas existentes e abre o arquivo para acrescentar novas */
+   void Open(const std::string& str_file);
+
+   bool Find(UInt64 un_hash, UInt32 un_seed, SResult& s_result) const;
+
+   void Store(UInt64 un_hash, UInt32 un_seed, const SResult& s_result,
+              const std::string& str_description);
+
+   inline size_t GetSize() const {
+      return m_mapResults.size();
+   }
+
+   /* FNV-1a de 64 bits */
+   static UInt64 Hash(const std::string& str_text);
+
+private:
+
+   typedef std::map<std::pair<UInt64, UInt32>, SResult> TResultMap;
+
+   TResultMap m_mapResults;
+   std::ofstream m_cFile;
+};
+
+#endif
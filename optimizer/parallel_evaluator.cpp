@@ -0,0 +1,148 @@
+#include "parallel_evaluator.h"
+#include <surrogate/surrogate_engine.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <map>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+CParallelEvaluator::CParallelEvaluator(TConfigurationNode& t_root,
+                                       const std::vector<std::string>& vec_names,
+                                       UInt32 un_workers,
+                                       UInt32 un_robots,
+                                       UInt32 un_length) :
+   m_tRoot(t_root),
+   m_vecNames(vec_names),
+   m_unWorkers(un_workers > 0 ? un_workers : 1),
+   m_unRobots(un_robots),
+   m_unLength(un_length) {}
+
+
+void CParallelEvaluator::Run(std::vector<SJob>& vec_jobs, CEvaluationCache& c_cache) {
+   /* pid -> (job, descritor de leitura do pipe) */
+   std::map<pid_t, std::pair<size_t, int> > mapRunning;
+   size_t unNext = 0;
+   while(unNext < vec_jobs.size() || ! mapRunning.empty()) {
+      /* dispara jobs enquanto houver processos livres */
+      while(mapRunning.size() < m_unWorkers && unNext < vec_jobs.size()) {
+         int pnFd[2];
+         if(::pipe(pnFd) != 0) {
+            KillAll();
+            THROW_ARGOSEXCEPTION("pipe() failed: " << ::strerror(errno));
+         }
+         pid_t tPid = ::fork();
+         if(tPid < 0) {
+            KillAll();
+            THROW_ARGOSEXCEPTION("fork() failed: " << ::strerror(errno));
+         }
+         if(tPid == 0) {
+            ::close(pnFd[0]);
+            RunChild(vec_jobs[unNext], pnFd[1]);
+         }
+         ::close(pnFd[1]);
+         mapRunning[tPid] = std::make_pair(unNext, pnFd[0]);
+         m_vecRunningPids.push_back(tPid);
+         ++unNext;
+      }
+      /* recolhe o primeiro que terminar */
+      int nStatus;
+      pid_t tPid = ::waitpid(-1, &nStatus, 0);
+      if(tPid < 0) {
+         if(errno == EINTR) continue;
+         KillAll();
+         THROW_ARGOSEXCEPTION("waitpid() failed: " << ::strerror(errno));
+      }
+      std::map<pid_t, std::pair<size_t, int> >::iterator it = mapRunning.find(tPid);
+      if(it == mapRunning.end()) continue;
+      SJob& sJob = vec_jobs[it->second.first];
+      char pchBuffer[512];
+      ssize_t nRead = ::read(it->second.second, pchBuffer, sizeof(pchBuffer) - 1);
+      ::close(it->second.second);
+      mapRunning.erase(it);
+      m_vecRunningPids.erase(std::find(m_vecRunningPids.begin(), m_vecRunningPids.end(), tPid));
+      pchBuffer[nRead > 0 ? nRead : 0] = '\0';
+      double fTicks, fEnergy;
+      if(! WIFEXITED(nStatus) || WEXITSTATUS(nStatus) != 0 ||
+         ::sscanf(pchBuffer, "%lf %lf", &fTicks, &fEnergy) != 2) {
+         KillAll();
+         /* o filho escreve "! mensagem" no pipe quando a simulação lança uma exceção */
+         pchBuffer[::strcspn(pchBuffer, "\n")] = '\0';
+         THROW_ARGOSEXCEPTION("Evaluation failed for seed " << sJob.Seed << ": " << sJob.Description
+                              << (pchBuffer[0] == '!' ? pchBuffer + 1 : ""));
+      }
+      sJob.Result.TicksToDetection = fTicks;
+      sJob.Result.EnergyPerRobot = fEnergy;
+      c_cache.Store(sJob.Hash, sJob.Seed, sJob.Result, sJob.Description);
+   }
+}
+
+
+void CParallelEvaluator::RunChild(const SJob& s_job, int n_fd) {
+   int nExit = 0;
+   /*
+    * Nenhuma exceção pode sair daqui: ela voltaria ao laço de gerações do pai,
+    * agora rodando no processo filho. Toda falha vira "! mensagem" no pipe.
+    */
+   std::string strError;
+   try {
+      /* o processo filho tem sua própria cópia da árvore XML */
+      TConfigurationNode& tState = GetNode(GetNode(GetNode(GetNode(m_tRoot, "controllers"),
+                                                           "footbot_foraging_controller"),
+                                                   "params"),
+                                           "state");
+      for(size_t i = 0; i < m_vecNames.size(); ++i) {
+         SetNodeAttribute(tState, m_vecNames[i], s_job.Values[i]);
+      }
+      CSurrogateEngine cEngine;
+      cEngine.SetRandomSeed(s_job.Seed);
+      cEngine.SetLength(m_unLength);
+      cEngine.SetOutputFile("/dev/null");
+      if(m_unRobots > 0) {
+         cEngine.SetNumRobots(m_unRobots);
+      }
+      cEngine.Init(m_tRoot);
+      cEngine.Execute();
+      const CSurrogateEngine::SStatistics& sStats = cEngine.GetStatistics();
+      Real fTicks = sStats.FirstDetection < 0 ? m_unLength : sStats.FirstDetection;
+      char pchBuffer[128];
+      int nLength = ::snprintf(pchBuffer, sizeof(pchBuffer), "%.17g %.17g\n",
+                               fTicks, static_cast<double>(sStats.Energy) / cEngine.GetNumRobots());
+      if(::write(n_fd, pchBuffer, nLength) != nLength) {
+         nExit = 1;
+      }
+      cEngine.Destroy();
+   }
+   catch(CARGoSException& ex) {
+      strError = ex.what();
+   }
+   catch(std::exception& ex) {
+      strError = ex.what();
+   }
+   catch(...) {
+      strError = "unknown exception";
+   }
+   if(! strError.empty()) {
+      ::fprintf(stderr, "%s\n", strError.c_str());
+      std::string strMessage = "! " + strError + "\n";
+      ssize_t nIgnored = ::write(n_fd, strMessage.c_str(), strMessage.size());
+      (void)nIgnored;
+      nExit = 1;
+   }
+   ::close(n_fd);
+   /* _exit: não descarrega os buffers herdados do processo pai */
+   ::_exit(nExit);
+}
+
+
+void CParallelEvaluator::KillAll() {
+   for(size_t i = 0; i < m_vecRunningPids.size(); ++i) {
+      ::kill(m_vecRunningPids[i], SIGTERM);
+      ::waitpid(m_vecRunningPids[i], NULL, 0);
+   }
+   m_vecRunningPids.clear();
+}
@@ -0,0 +1,63 @@
+#ifndef PARALLEL_EVALUATOR_H
+#define PARALLEL_EVALUATOR_H
+
+/*
+ * Avalia conjuntos de parâmetros de <state> no motor substituto, cada
+ * (candidato, semente) em um processo filho. No máximo N filhos rodam ao
+ * mesmo tempo e os resultados são recolhidos na ordem em que terminam: um
+ * processo livre recebe logo o próximo job.
+ *
+ * Run() só volta quando todos os jobs da geração terminaram. A barreira é de
+ * propósito: o CMA-ES só amostra a geração seguinte depois de Tell() com os
+ * custos de todos os candidatos. Uma geração tem lambda * k jobs (10 * 8 = 80
+ * no padrão), então só a cauda, com menos de N jobs, deixa processos parados.
+ */
+
+#include "evaluation_cache.h"
+#include <argos3/core/utility/configuration/argos_configuration.h>
+#include <string>
+#include <vector>
+
+using namespace argos;
+
+class CParallelEvaluator {
+
+public:
+
+   struct SJob {
+      std::vector<std::string> Values;     // valores dos atributos de <state>, já formatados
+      UInt32 Seed;
+      UInt64 Hash;                         // chave do cache para Values
+      std::string Description;             // "nome=valor;..." gravado no cache
+      CEvaluationCache::SResult Result;
+   };
+
+public:
+
+   CParallelEvaluator(TConfigurationNode& t_root,
+                      const std::vector<std::string>& vec_names,
+                      UInt32 un_workers,
+                      UInt32 un_robots,
+                      UInt32 un_length);
+
+   /* roda todos os jobs e grava cada resultado no cache assim que ele fica pronto */
+   void Run(std::vector<SJob>& vec_jobs, CEvaluationCache& c_cache);
+
+private:
+
+   /* executado no processo filho: simula e escreve o resultado em n_fd */
+   void RunChild(const SJob& s_job, int n_fd);
+
+   void KillAll();
+
+private:
+
+   TConfigurationNode& m_tRoot;
+   std::vector<std::string> m_vecNames;
+   UInt32 m_unWorkers;
+   UInt32 m_unRobots;
+   UInt32 m_unLength;
+   std::vector<int> m_vecRunningPids;
+};
+
+#endif
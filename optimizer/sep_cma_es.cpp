@@ -0,0 +1,121 @@
+#include "sep_cma_es.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+/* ordena índices da população pelo custo */
+struct SCostOrder {
+   const std::vector<Real>* Costs;
+   bool operator()(size_t un_a, size_t un_b) const {
+      return (*Costs)[un_a] < (*Costs)[un_b];
+   }
+};
+
+
+CSepCMAES::CSepCMAES(size_t un_dimensions, const std::vector<Real>& vec_initial_mean,
+                     Real f_initial_sigma, UInt32 un_seed) :
+   m_unN(un_dimensions),
+   m_unGeneration(0),
+   m_fSigma(f_initial_sigma),
+   m_vecMean(vec_initial_mean),
+   m_vecDiagC(un_dimensions, 1.0f),
+   m_vecPathSigma(un_dimensions, 0.0f),
+   m_vecPathC(un_dimensions, 0.0f) {
+   Real fN = m_unN;
+   /* parâmetros padrão de Hansen */
+   m_unLambda = 4 + static_cast<size_t>(3.0f * std::log(fN));
+   m_unMu = m_unLambda / 2;
+   Real fWeightSum = 0.0f, fWeightSqSum = 0.0f;
+   for(size_t i = 0; i < m_unMu; ++i) {
+      m_vecWeights.push_back(std::log(m_unMu + 0.5f) - std::log(i + 1.0f));
+      fWeightSum += m_vecWeights.back();
+   }
+   for(size_t i = 0; i < m_unMu; ++i) {
+      m_vecWeights[i] /= fWeightSum;
+      fWeightSqSum += m_vecWeights[i] * m_vecWeights[i];
+   }
+   m_fMuEff = 1.0f / fWeightSqSum;
+   m_fCSigma = (m_fMuEff + 2.0f) / (fN + m_fMuEff + 5.0f);
+   m_fDSigma = 1.0f + 2.0f * std::max<Real>(0.0f, std::sqrt((m_fMuEff - 1.0f) / (fN + 1.0f)) - 1.0f) + m_fCSigma;
+   m_fCC = (4.0f + m_fMuEff / fN) / (fN + 4.0f + 2.0f * m_fMuEff / fN);
+   m_fC1 = 2.0f / ((fN + 1.3f) * (fN + 1.3f) + m_fMuEff);
+   m_fCMu = std::min<Real>(1.0f - m_fC1,
+                           2.0f * (m_fMuEff - 2.0f + 1.0f / m_fMuEff) / ((fN + 2.0f) * (fN + 2.0f) + m_fMuEff));
+   /* a versão separável aprende a diagonal mais rápido */
+   m_fC1  *= (fN + 2.0f) / 3.0f;
+   m_fCMu  = std::min<Real>(1.0f - m_fC1, m_fCMu * (fN + 2.0f) / 3.0f);
+   m_fChiN = std::sqrt(fN) * (1.0f - 1.0f / (4.0f * fN) + 1.0f / (21.0f * fN * fN));
+   m_vecPopulation.resize(m_unLambda, std::vector<Real>(m_unN));
+   /* categoria própria, para não depender da categoria "argos" do motor */
+   std::ostringstream cCategory;
+   cCategory << "sep_cma_es_" << this;
+   m_strRNGCategory = cCategory.str();
+   CRandom::CreateCategory(m_strRNGCategory, un_seed);
+   m_pcRNG = CRandom::CreateRNG(m_strRNGCategory);
+}
+
+
+CSepCMAES::~CSepCMAES() {
+   CRandom::RemoveCategory(m_strRNGCategory);
+}
+
+
+const std::vector< std::vector<Real> >& CSepCMAES::Ask() {
+   for(size_t k = 0; k < m_unLambda; ++k) {
+      for(size_t i = 0; i < m_unN; ++i) {
+         Real fX = m_vecMean[i] + m_fSigma * std::sqrt(m_vecDiagC[i]) * m_pcRNG->Gaussian(1.0f);
+         /* reparo por truncamento: o ponto avaliado é o mesmo usado em Tell() */
+         m_vecPopulation[k][i] = std::max<Real>(0.0f, std::min<Real>(1.0f, fX));
+      }
+   }
+   return m_vecPopulation;
+}
+
+
+void CSepCMAES::Tell(const std::vector<Real>& vec_costs) {
+   std::vector<size_t> vecOrder(m_unLambda);
+   for(size_t k = 0; k < m_unLambda; ++k) vecOrder[k] = k;
+   SCostOrder sOrder;
+   sOrder.Costs = &vec_costs;
+   std::sort(vecOrder.begin(), vecOrder.end(), sOrder);
+   /* passo médio ponderado dos mu melhores, em unidades de sigma */
+   std::vector<Real> vecStep(m_unN, 0.0f);
+   for(size_t r = 0; r < m_unMu; ++r) {
+      const std::vector<Real>& vecX = m_vecPopulation[vecOrder[r]];
+      for(size_t i = 0; i < m_unN; ++i) {
+         vecStep[i] += m_vecWeights[r] * (vecX[i] - m_vecMean[i]) / m_fSigma;
+      }
+   }
+   for(size_t i = 0; i < m_unN; ++i) {
+      m_vecMean[i] += m_fSigma * vecStep[i];
+   }
+   /* caminhos de evolução */
+   Real fSigmaNorm = 0.0f;
+   Real fCSigmaFactor = std::sqrt(m_fCSigma * (2.0f - m_fCSigma) * m_fMuEff);
+   for(size_t i = 0; i < m_unN; ++i) {
+      m_vecPathSigma[i] = (1.0f - m_fCSigma) * m_vecPathSigma[i] +
+         fCSigmaFactor * vecStep[i] / std::sqrt(m_vecDiagC[i]);
+      fSigmaNorm += m_vecPathSigma[i] * m_vecPathSigma[i];
+   }
+   fSigmaNorm = std::sqrt(fSigmaNorm);
+   ++m_unGeneration;
+   bool bHSigma = fSigmaNorm / std::sqrt(1.0f - std::pow(1.0f - m_fCSigma, 2.0f * m_unGeneration)) <
+      (1.4f + 2.0f / (m_unN + 1.0f)) * m_fChiN;
+   Real fCCFactor = std::sqrt(m_fCC * (2.0f - m_fCC) * m_fMuEff);
+   for(size_t i = 0; i < m_unN; ++i) {
+      m_vecPathC[i] = (1.0f - m_fCC) * m_vecPathC[i] + (bHSigma ? fCCFactor * vecStep[i] : 0.0f);
+   }
+   /* covariância diagonal: atualização rank-one + rank-mu */
+   for(size_t i = 0; i < m_unN; ++i) {
+      Real fRankMu = 0.0f;
+      for(size_t r = 0; r < m_unMu; ++r) {
+         Real fY = (m_vecPopulation[vecOrder[r]][i] - (m_vecMean[i] - m_fSigma * vecStep[i])) / m_fSigma;
+         fRankMu += m_vecWeights[r] * fY * fY;
+      }
+      m_vecDiagC[i] = (1.0f - m_fC1 - m_fCMu) * m_vecDiagC[i] +
+         m_fC1 * (m_vecPathC[i] * m_vecPathC[i] +
+                  (bHSigma ? 0.0f : m_fCC * (2.0f - m_fCC) * m_vecDiagC[i])) +
+         m_fCMu * fRankMu;
+   }
+   m_fSigma *= std::exp((m_fCSigma / m_fDSigma) * (fSigmaNorm / m_fChiN - 1.0f));
+}
@@ -0,0 +1,69 @@
+#ifndef SEP_CMA_ES_H
+#define SEP_CMA_ES_H
+
+/*
+ * CMA-ES separável (covariância diagonal, Ros & Hansen 2008) no cubo [0,1]^n.
+ * A amostragem só depende da semente, então repetir a otimização desde a
+ * geração 0 reproduz exatamente os mesmos candidatos (usado para retomar
+ * uma otimização interrompida a partir do cache de avaliações).
+ */
+
+#include <argos3/core/utility/math/rng.h>
+#include <string>
+#include <vector>
+
+using namespace argos;
+
+class CSepCMAES {
+
+public:
+
+   CSepCMAES(size_t un_dimensions, const std::vector<Real>& vec_initial_mean,
+             Real f_initial_sigma, UInt32 un_seed);
+   ~CSepCMAES();
+
+   /* amostra uma nova população de candidatos, cada coordenada em [0,1] */
+   const std::vector< std::vector<Real> >& Ask();
+
+   /* atualiza a distribuição com o custo de cada candidato (menor é melhor) */
+   void Tell(const std::vector<Real>& vec_costs);
+
+   inline size_t GetPopulationSize() const {
+      return m_unLambda;
+   }
+
+   inline UInt32 GetGeneration() const {
+      return m_unGeneration;
+   }
+
+   inline Real GetSigma() const {
+      return m_fSigma;
+   }
+
+   inline const std::vector<Real>& GetMean() const {
+      return m_vecMean;
+   }
+
+private:
+
+   size_t m_unN;
+   size_t m_unLambda;
+   size_t m_unMu;
+   std::vector<Real> m_vecWeights;
+   Real m_fMuEff;
+   Real m_fCSigma, m_fDSigma, m_fCC, m_fC1, m_fCMu;
+   Real m_fChiN;
+
+   UInt32 m_unGeneration;
+   Real m_fSigma;
+   std::vector<Real> m_vecMean;
+   std::vector<Real> m_vecDiagC;
+   std::vector<Real> m_vecPathSigma;
+   std::vector<Real> m_vecPathC;
+   std::vector< std::vector<Real> > m_vecPopulation;
+
+   std::string m_strRNGCategory;
+   CRandom::CRNG* m_pcRNG;
+};
+
+#endif
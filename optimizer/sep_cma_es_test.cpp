@@ -0,0 +1,100 @@
+/*
+ * Testes do CMA-ES separável: convergência numa esfera com pesos, limites
+ * do cubo [0,1]^n e reprodutibilidade pela semente (base da retomada).
+ */
+
+#include "sep_cma_es.h"
+#include <testing/unit_test.h>
+#include <cmath>
+#include <iostream>
+
+/* esfera com pesos 1..n e mínimo em vec_optimum */
+static void EvaluateSphere(const std::vector< std::vector<Real> >& vec_population,
+                           const std::vector<Real>& vec_optimum,
+                           std::vector<Real>& vec_costs) {
+   vec_costs.resize(vec_population.size());
+   for(size_t k = 0; k < vec_population.size(); ++k) {
+      vec_costs[k] = 0.0f;
+      for(size_t i = 0; i < vec_optimum.size(); ++i) {
+         Real fDelta = vec_population[k][i] - vec_optimum[i];
+         vec_costs[k] += (i + 1) * fDelta * fDelta;
+      }
+   }
+}
+
+/****************************************/
+/****************************************/
+
+static void TestConvergence() {
+   const size_t unN = 10;
+   std::vector<Real> vecOptimum(unN, 0.3f);
+   /* uma coordenada com o mínimo na borda do cubo */
+   vecOptimum[unN - 1] = 0.0f;
+   CSepCMAES cOptimizer(unN, std::vector<Real>(unN, 0.9f), 0.3f, 1);
+   /* padrão de Hansen: 4 + floor(3 ln n) */
+   CHECK(cOptimizer.GetPopulationSize() == 10);
+   std::vector<Real> vecCosts;
+   for(UInt32 g = 0; g < 300; ++g) {
+      EvaluateSphere(cOptimizer.Ask(), vecOptimum, vecCosts);
+      cOptimizer.Tell(vecCosts);
+   }
+   CHECK(cOptimizer.GetGeneration() == 300);
+   CHECK(cOptimizer.GetSigma() < 0.01f);
+   for(size_t i = 0; i < unN; ++i) {
+      CHECK(std::fabs(cOptimizer.GetMean()[i] - vecOptimum[i]) < 0.01f);
+   }
+}
+
+
+static void TestBounds() {
+   /* média perto da borda e passo grande: toda amostra fica no cubo */
+   CSepCMAES cOptimizer(4, std::vector<Real>(4, 0.95f), 0.5f, 7);
+   std::vector<Real> vecOptimum(4, 1.0f);
+   std::vector<Real> vecCosts;
+   for(UInt32 g = 0; g < 20; ++g) {
+      const std::vector< std::vector<Real> >& vecPopulation = cOptimizer.Ask();
+      for(size_t k = 0; k < vecPopulation.size(); ++k) {
+         for(size_t i = 0; i < vecPopulation[k].size(); ++i) {
+            CHECK(vecPopulation[k][i] >= 0.0f && vecPopulation[k][i] <= 1.0f);
+         }
+      }
+      EvaluateSphere(vecPopulation, vecOptimum, vecCosts);
+      cOptimizer.Tell(vecCosts);
+   }
+}
+
+
+static void TestReproducible() {
+   /* mesma semente e mesmos custos: mesmos candidatos em toda geração */
+   std::vector<Real> vecOptimum(6, 0.6f);
+   CSepCMAES cFirst(6, std::vector<Real>(6, 0.5f), 0.2f, 42);
+   CSepCMAES cSecond(6, std::vector<Real>(6, 0.5f), 0.2f, 42);
+   CSepCMAES cOther(6, std::vector<Real>(6, 0.5f), 0.2f, 43);
+   std::vector<Real> vecCosts;
+   bool bSame = true, bOtherDiffers = false;
+   for(UInt32 g = 0; g < 10; ++g) {
+      std::vector< std::vector<Real> > vecFirst = cFirst.Ask();
+      const std::vector< std::vector<Real> >& vecSecond = cSecond.Ask();
+      const std::vector< std::vector<Real> >& vecOther = cOther.Ask();
+      bSame = bSame && vecFirst == vecSecond;
+      bOtherDiffers = bOtherDiffers || vecFirst != vecOther;
+      EvaluateSphere(vecFirst, vecOptimum, vecCosts);
+      cFirst.Tell(vecCosts);
+      cSecond.Tell(vecCosts);
+      EvaluateSphere(vecOther, vecOptimum, vecCosts);
+      cOther.Tell(vecCosts);
+   }
+   CHECK(bSame);
+   CHECK(bOtherDiffers);
+   CHECK(cFirst.GetMean() == cSecond.GetMean());
+}
+
+/****************************************/
+/****************************************/
+
+int main() {
+   TestConvergence();
+   TestBounds();
+   TestReproducible();
+   return TestResult();
+}
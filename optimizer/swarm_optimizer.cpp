@@ -0,0 +1,263 @@
+/*
+ * swarm_optimizer: ajusta as probabilidades e tempos de <state> do
+ * FootBotTrack com CMA-ES separável, avaliando cada candidato em várias
+ * sementes no motor substituto, em processos paralelos.
+ *
+ * uso: swarm_optimizer -c experimento.argos [-w processos] [-g gerações] [-k sementes]
+ *                      [-l passos] [-n robôs] [-e peso_energia] [-s semente] [-f cache]
+ *
+ * Custo de um candidato (média sobre as sementes 1..k, menor é melhor):
+ *    (1 - peso_energia) * passo_do_primeiro_alvo / passos
+ *       + peso_energia * (-energia_por_robô) / passos
+ *
+ * -w: padrão é o número de núcleos, no máximo 256.
+ *
+ * Retomar: rodar de novo o mesmo comando. Os candidatos de cada geração só
+ * dependem de -s, então as gerações já avaliadas saem inteiras do cache.
+ */
+
+#include "sep_cma_es.h"
+#include "evaluation_cache.h"
+#include "parallel_evaluator.h"
+#include <argos3/core/utility/logging/argos_log.h>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <unistd.h>
+
+/* parâmetros otimizados e seus intervalos */
+struct SParameter {
+   const char* Name;
+   Real Min;
+   Real Max;
+   bool Integer;
+};
+
+static const SParameter PARAMETERS[] = {
+   { "initial_rest_to_explore_prob",              0.0f, 1.0f,     false },
+   { "initial_explore_to_rest_prob",              0.0f, 1.0f,     false },
+   { "food_rule_explore_to_rest_delta_prob",      0.0f, 0.1f,     false },
+   { "food_rule_rest_to_explore_delta_prob",      0.0f, 0.1f,     false },
+   { "collision_rule_explore_to_rest_delta_prob", 0.0f, 0.1f,     false },
+   { "social_rule_explore_to_rest_delta_prob",    0.0f, 0.1f,     false },
+   { "social_rule_rest_to_explore_delta_prob",    0.0f, 0.1f,     false },
+   { "minimum_resting_time",                      0.0f, 500.0f,   true  },
+   { "minimum_unsuccessful_explore_time",         0.0f, 12000.0f, true  },
+   { "minimum_search_for_place_in_nest_time",     0.0f, 500.0f,   true  }
+};
+
+static const size_t NUM_PARAMETERS = sizeof(PARAMETERS) / sizeof(PARAMETERS[0]);
+
+/* mais processos que isso só disputam memória e CPU */
+static const long MAX_WORKERS = 256;
+
+// converte um ponto de [0,1]^n nos valores dos atributos de <state>
+
+static std::vector<std::string> Decode(const std::vector<Real>& vec_point) {
+   std::vector<std::string> vecValues(NUM_PARAMETERS);
+   for(size_t i = 0; i < NUM_PARAMETERS; ++i) {
+      Real fValue = PARAMETERS[i].Min + vec_point[i] * (PARAMETERS[i].Max - PARAMETERS[i].Min);
+      std::ostringstream cValue;
+      if(PARAMETERS[i].Integer) {
+         cValue << static_cast<UInt32>(fValue + 0.5f);
+      }
+      else {
+         /* 6 algarismos: candidatos indistinguíveis compartilham a entrada do cache */
+         cValue << std::setprecision(6) << fValue;
+      }
+      vecValues[i] = cValue.str();
+   }
+   return vecValues;
+}
+
+
+static std::string Describe(const std::vector<std::string>& vec_values) {
+   std::ostringstream cDescription;
+   for(size_t i = 0; i < NUM_PARAMETERS; ++i) {
+      cDescription << PARAMETERS[i].Name << "=\"" << vec_values[i] << "\" ";
+   }
+   return cDescription.str();
+}
+
+
+/*
+ * Parte da chave do cache que descreve o cenário: só o que muda a simulação
+ * no motor substituto. Entram a arena, os parâmetros do controlador (sem os
+ * atributos otimizados, que só definem o ponto inicial), <foraging> sem o
+ * arquivo de saída, ticks_per_second, os robôs e a duração. Visualização e
+ * caminhos de saída não invalidam o cache; a semente faz parte de cada entrada.
+ */
+
+static std::string DescribeScenario(TConfigurationNode& t_root,
+                                    TConfigurationNode& t_params,
+                                    UInt32 un_robots,
+                                    UInt32 un_length) {
+   std::ostringstream cScenario;
+   cScenario << GetNode(t_root, "arena") << "|" << t_params << "|";
+   TConfigurationNode& tForaging = GetNode(GetNode(t_root, "loop_functions"), "foraging");
+   ticpp::Iterator<ticpp::Attribute> itAttribute;
+   for(itAttribute = itAttribute.begin(&tForaging);
+       itAttribute != itAttribute.end();
+       ++itAttribute) {
+      if(itAttribute->Name() != "output") {
+         cScenario << itAttribute->Name() << "=\"" << itAttribute->Value() << "\" ";
+      }
+   }
+   TConfigurationNodeIterator itChild;
+   for(itChild = itChild.begin(&tForaging);
+       itChild != itChild.end();
+       ++itChild) {
+      cScenario << *itChild;
+   }
+   UInt32 unTicksPerSecond;
+   GetNodeAttribute(GetNode(GetNode(t_root, "framework"), "experiment"),
+                    "ticks_per_second", unTicksPerSecond);
+   cScenario << "|" << unTicksPerSecond << "|" << un_robots << "|" << un_length << "|";
+   return cScenario.str();
+}
+
+
+static void PrintUsage(const char* pch_program) {
+   LOGERR << "uso: " << pch_program
+          << " -c experimento.argos [-w processos] [-g gerações] [-k sementes]"
+          << " [-l passos] [-n robôs] [-e peso_energia] [-s semente] [-f cache]"
+          << std::endl;
+}
+
+
+int main(int argc, char** argv) {
+   std::string strExperiment;
+   std::string strCache = "optimizer_cache.tsv";
+   /* sysconf devolve -1 quando não sabe: um processo só */
+   long nWorkers = ::sysconf(_SC_NPROCESSORS_ONLN);
+   if(nWorkers <= 0) {
+      nWorkers = 1;
+   }
+   UInt32 unGenerations = 50;
+   UInt32 unSeeds = 8;
+   UInt32 unLength = 6000;
+   UInt32 unRobots = 0;
+   UInt32 unSeed = 1;
+   Real fEnergyWeight = 0.3f;
+   for(int i = 1; i < argc; ++i) {
+      if(i + 1 >= argc) {
+         PrintUsage(argv[0]);
+         return 1;
+      }
+      if(::strcmp(argv[i], "-c") == 0)      strExperiment = argv[++i];
+      else if(::strcmp(argv[i], "-w") == 0) nWorkers = ::strtol(argv[++i], NULL, 10);
+      else if(::strcmp(argv[i], "-g") == 0) unGenerations = ::strtoul(argv[++i], NULL, 10);
+      else if(::strcmp(argv[i], "-k") == 0) unSeeds = ::strtoul(argv[++i], NULL, 10);
+      else if(::strcmp(argv[i], "-l") == 0) unLength = ::strtoul(argv[++i], NULL, 10);
+      else if(::strcmp(argv[i], "-n") == 0) unRobots = ::strtoul(argv[++i], NULL, 10);
+      else if(::strcmp(argv[i], "-e") == 0) fEnergyWeight = ::atof(argv[++i]);
+      else if(::strcmp(argv[i], "-s") == 0) unSeed = ::strtoul(argv[++i], NULL, 10);
+      else if(::strcmp(argv[i], "-f") == 0) strCache = argv[++i];
+      else {
+         PrintUsage(argv[0]);
+         return 1;
+      }
+   }
+   if(strExperiment.empty() || unLength == 0 || unSeeds == 0 || nWorkers <= 0) {
+      PrintUsage(argv[0]);
+      return 1;
+   }
+   if(nWorkers > MAX_WORKERS) {
+      LOG << "processos: " << nWorkers << " reduzidos para " << MAX_WORKERS << std::endl;
+      nWorkers = MAX_WORKERS;
+   }
+   try {
+      ticpp::Document tConfiguration;
+      tConfiguration.LoadFile(strExperiment);
+      TConfigurationNode& tRoot = *tConfiguration.FirstChildElement();
+      /* ponto inicial: os valores atuais do arquivo */
+      TConfigurationNode& tParams = GetNode(GetNode(GetNode(tRoot, "controllers"),
+                                                    "footbot_foraging_controller"),
+                                            "params");
+      TConfigurationNode& tState = GetNode(tParams, "state");
+      std::vector<std::string> vecNames;
+      std::vector<Real> vecInitial;
+      for(size_t i = 0; i < NUM_PARAMETERS; ++i) {
+         Real fValue;
+         GetNodeAttribute(tState, PARAMETERS[i].Name, fValue);
+         vecNames.push_back(PARAMETERS[i].Name);
+         vecInitial.push_back(Max<Real>(0.0f, Min<Real>(1.0f,
+            (fValue - PARAMETERS[i].Min) / (PARAMETERS[i].Max - PARAMETERS[i].Min))));
+      }
+      /* os processos filhos recolocam os atributos otimizados em cada avaliação */
+      for(size_t i = 0; i < NUM_PARAMETERS; ++i) {
+         tState.RemoveAttribute(PARAMETERS[i].Name);
+      }
+      std::string strScenario = DescribeScenario(tRoot, tParams, unRobots, unLength);
+      CEvaluationCache cCache;
+      cCache.Open(strCache);
+      LOG << "cache: " << cCache.GetSize() << " avaliações em " << strCache << std::endl;
+      CParallelEvaluator cEvaluator(tRoot, vecNames, static_cast<UInt32>(nWorkers), unRobots, unLength);
+      CSepCMAES cOptimizer(NUM_PARAMETERS, vecInitial, 0.3f, unSeed);
+      Real fBestCost = -1.0f;
+      std::string strBest;
+      for(UInt32 g = 0; g < unGenerations; ++g) {
+         const std::vector< std::vector<Real> >& vecPopulation = cOptimizer.Ask();
+         /* monta os jobs que ainda não estão no cache */
+         std::vector< std::vector<std::string> > vecValues(vecPopulation.size());
+         std::vector<UInt64> vecHashes(vecPopulation.size());
+         std::vector<CParallelEvaluator::SJob> vecJobs;
+         for(size_t k = 0; k < vecPopulation.size(); ++k) {
+            vecValues[k] = Decode(vecPopulation[k]);
+            std::string strDescription = Describe(vecValues[k]);
+            vecHashes[k] = CEvaluationCache::Hash(strScenario + strDescription);
+            for(UInt32 s = 1; s <= unSeeds; ++s) {
+               CParallelEvaluator::SJob sJob;
+               if(cCache.Find(vecHashes[k], s, sJob.Result)) continue;
+               sJob.Values = vecValues[k];
+               sJob.Seed = s;
+               sJob.Hash = vecHashes[k];
+               sJob.Description = strDescription;
+               vecJobs.push_back(sJob);
+            }
+         }
+         cEvaluator.Run(vecJobs, cCache);
+         /* custo médio de cada candidato sobre as sementes */
+         std::vector<Real> vecCosts(vecPopulation.size(), 0.0f);
+         size_t unBest = 0;
+         for(size_t k = 0; k < vecPopulation.size(); ++k) {
+            for(UInt32 s = 1; s <= unSeeds; ++s) {
+               CEvaluationCache::SResult sResult;
+               cCache.Find(vecHashes[k], s, sResult);
+               vecCosts[k] += ((1.0f - fEnergyWeight) * sResult.TicksToDetection +
+                               fEnergyWeight * -sResult.EnergyPerRobot) / (unLength * unSeeds);
+            }
+            if(vecCosts[k] < vecCosts[unBest]) unBest = k;
+         }
+         if(fBestCost < 0.0f || vecCosts[unBest] < fBestCost) {
+            fBestCost = vecCosts[unBest];
+            strBest = Describe(vecValues[unBest]);
+         }
+         cOptimizer.Tell(vecCosts);
+         LOG << "geração " << g
+             << "  simulações: " << vecJobs.size()
+             << "  melhor custo: " << vecCosts[unBest]
+             << "  sigma: " << cOptimizer.GetSigma()
+             << std::endl;
+         LOG.Flush();
+      }
+      LOG << "melhor custo: " << fBestCost << std::endl
+          << "<state " << strBest << "/>" << std::endl;
+   }
+   catch(CARGoSException& ex) {
+      LOGERR << ex.what() << std::endl;
+      LOG.Flush();
+      LOGERR.Flush();
+      return 1;
+   }
+   catch(ticpp::Exception& ex) {
+      LOGERR << ex.what() << std::endl;
+      LOG.Flush();
+      LOGERR.Flush();
+      return 1;
+   }
+   LOG.Flush();
+   LOGERR.Flush();
+   return 0;
+}
@@ -0,0 +1,16 @@
+#include "allocation_counter.h"
+
+/* inicialização constante: válida antes de qualquer construtor estático chamar new */
+bool CAllocationCounter::s_bInstalled = false;
+bool CAllocationCounter::s_bEnabled = false;
+UInt32 CAllocationCounter::s_unPhase = 0;
+UInt64 CAllocationCounter::s_punNews[CAllocationCounter::MAX_PHASES] = { 0 };
+UInt64 CAllocationCounter::s_punDeletes[CAllocationCounter::MAX_PHASES] = { 0 };
+
+
+void CAllocationCounter::Reset() {
+   for(UInt32 i = 0; i < MAX_PHASES; ++i) {
+      s_punNews[i] = 0;
+      s_punDeletes[i] = 0;
+   }
+}
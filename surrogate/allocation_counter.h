@@ -0,0 +1,71 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+/*
+ * Contadores de operator new/delete por fase do passo.
+ *
+ * O motor substituto informa a fase atual com SetPhase(); quem conta são as
+ * versões de operator new/delete de benchmark/allocation_hooks.cpp, que só
+ * existem nos executáveis que as ligam. Sem elas IsInstalled() é falso e os
+ * contadores ficam em zero.
+ *
+ * Contadores simples, sem atômicos: o motor substituto roda em uma só thread.
+ */
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+
+using namespace argos;
+
+class CAllocationCounter {
+
+public:
+
+   /* fases distintas que podem ser contadas (CSurrogateEngine::EPhase e "fora do passo") */
+   static const UInt32 MAX_PHASES = 8;
+
+   static inline void SetPhase(UInt32 un_phase) {
+      s_unPhase = un_phase < MAX_PHASES ? un_phase : MAX_PHASES - 1;
+   }
+
+   static inline void SetEnabled(bool b_enabled) {
+      s_bEnabled = b_enabled;
+   }
+
+   static inline bool IsInstalled() {
+      return s_bInstalled;
+   }
+
+   /* zera todos os contadores */
+   static void Reset();
+
+   static inline UInt64 GetNews(UInt32 un_phase) {
+      return s_punNews[un_phase];
+   }
+
+   static inline UInt64 GetDeletes(UInt32 un_phase) {
+      return s_punDeletes[un_phase];
+   }
+
+   /* chamados pelas versões instaladas de operator new/delete */
+   static inline void Install() {
+      s_bInstalled = true;
+   }
+
+   static inline void CountNew() {
+      if(s_bEnabled) ++s_punNews[s_unPhase];
+   }
+
+   static inline void CountDelete() {
+      if(s_bEnabled) ++s_punDeletes[s_unPhase];
+   }
+
+private:
+
+   static bool s_bInstalled;
+   static bool s_bEnabled;
+   static UInt32 s_unPhase;
+   static UInt64 s_punNews[MAX_PHASES];
+   static UInt64 s_punDeletes[MAX_PHASES];
+};
+
+#endif
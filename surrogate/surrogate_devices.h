@@ -0,0 +1,124 @@
+#ifndef SURROGATE_DEVICES_H
+#define SURROGATE_DEVICES_H
+
+/*
+ * Sensores e atuadores "falsos" usados pelo motor substituto.
+ * Eles implementam as mesmas interfaces CCI que o FootBotTrack usa no ARGoS,
+ * mas as leituras são escritas diretamente pelo CSurrogateEngine a partir
+ * das posições dos robôs, sem motor físico nem medium.
+ */
+
+#include <argos3/plugins/robots/generic/control_interface/ci_differential_steering_actuator.h>
+#include <argos3/plugins/robots/generic/control_interface/ci_leds_actuator.h>
+#include <argos3/plugins/robots/generic/control_interface/ci_range_and_bearing_actuator.h>
+#include <argos3/plugins/robots/generic/control_interface/ci_range_and_bearing_sensor.h>
+#include <argos3/plugins/robots/foot-bot/control_interface/ci_footbot_proximity_sensor.h>
+#include <argos3/plugins/robots/foot-bot/control_interface/ci_footbot_light_sensor.h>
+#include <argos3/plugins/robots/foot-bot/control_interface/ci_footbot_motor_ground_sensor.h>
+#include <vector>
+
+using namespace argos;
+
+// rodas: a velocidade pedida é escrita direto nos vetores do motor
+
+class CSurrogateWheels : public CCI_DifferentialSteeringActuator {
+
+public:
+
+   CSurrogateWheels(std::vector<Real>& vec_left,
+                    std::vector<Real>& vec_right,
+                    size_t un_index) :
+      m_vecLeft(vec_left),
+      m_vecRight(vec_right),
+      m_unIndex(un_index) {}
+
+   virtual ~CSurrogateWheels() {}
+
+   virtual void SetLinearVelocity(Real f_left_velocity,
+                                  Real f_right_velocity) {
+      m_vecLeft[m_unIndex]  = f_left_velocity;
+      m_vecRight[m_unIndex] = f_right_velocity;
+   }
+
+private:
+
+   std::vector<Real>& m_vecLeft;
+   std::vector<Real>& m_vecRight;
+   size_t m_unIndex;
+};
+
+// LEDs não influenciam nenhum sensor do substituto
+
+class CSurrogateLEDs : public CCI_LEDsActuator {
+
+public:
+
+   virtual ~CSurrogateLEDs() {}
+};
+
+// range and bearing: o pacote de cada robô é lido pelos vizinhos no próximo passo
+
+class CSurrogateRABActuator : public CCI_RangeAndBearingActuator {
+
+public:
+
+   /* tamanho do pacote do foot-bot no ARGoS */
+   static const size_t DATA_SIZE = 10;
+
+   CSurrogateRABActuator() {
+      m_cData.Resize(DATA_SIZE);
+   }
+
+   virtual ~CSurrogateRABActuator() {}
+
+   /* pacote atual (m_cData é protegido em CCI_RangeAndBearingActuator) */
+   inline const CByteArray& GetPacketData() const {
+      return m_cData;
+   }
+};
+
+class CSurrogateRABSensor : public CCI_RangeAndBearingSensor {
+
+public:
+
+   virtual ~CSurrogateRABSensor() {}
+
+   inline TReadings& GetMutableReadings() {
+      return m_tReadings;
+   }
+};
+
+class CSurrogateProximitySensor : public CCI_FootBotProximitySensor {
+
+public:
+
+   virtual ~CSurrogateProximitySensor() {}
+
+   inline TReadings& GetMutableReadings() {
+      return m_tReadings;
+   }
+};
+
+class CSurrogateLightSensor : public CCI_FootBotLightSensor {
+
+public:
+
+   virtual ~CSurrogateLightSensor() {}
+
+   inline TReadings& GetMutableReadings() {
+      return m_tReadings;
+   }
+};
+
+class CSurrogateGroundSensor : public CCI_FootBotMotorGroundSensor {
+
+public:
+
+   virtual ~CSurrogateGroundSensor() {}
+
+   inline TReadings& GetMutableReadings() {
+      return m_tReadings;
+   }
+};
+
+#endif
@@ -0,0 +1,671 @@
+#include "surrogate_engine.h"
+#include "allocation_counter.h"
+#include <argos3/core/utility/logging/argos_log.h>
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <sstream>
+
+/* Dimensões do foot-bot e alcance dos sensores (mesmos valores do ARGoS) */
+static const Real FOOTBOT_RADIUS            = 0.085036758f;
+static const Real FOOTBOT_INTERWHEEL        = 0.14f;
+static const Real FOOTBOT_LIGHT_HEIGHT      = 0.1f;
+static const Real PROXIMITY_RANGE           = 0.1f;
+static const Real RAB_RANGE                 = 3.0f;
+/* célula da grade do range and bearing: com 1 m, a consulta de 3 m percorre
+ * ~1.5x a área do círculo, contra ~2.6x com células de 3 m */
+static const Real RAB_CELL_SIZE             = RAB_RANGE / 3.0f;
+
+
+CSurrogateEngine::CSurrogateEngine() :
+   m_unRandomSeed(0),
+   m_bSeedSet(false),
+   m_unNumRobotsOverride(0),
+   m_unLengthOverride(0),
+   m_unLength(0),
+   m_fTickLength(0.1f),
+   m_unClock(0),
+   m_pcRNG(NULL),
+   m_ptRoot(NULL),
+   m_ePhase(NUM_PHASES),
+   m_fPhaseStart(0.0) {
+   ResetPhaseTimes();
+}
+
+
+CSurrogateEngine::~CSurrogateEngine() {
+   Destroy();
+}
+
+// Inicializa o experimento a partir do arquivo .argos
+
+void CSurrogateEngine::Init(const std::string& str_experiment_file) {
+   ticpp::Document tConfiguration;
+   try {
+      tConfiguration.LoadFile(str_experiment_file);
+   }
+   catch(ticpp::Exception& ex) {
+      THROW_ARGOSEXCEPTION("Error loading experiment file \"" << str_experiment_file << "\": " << ex.what());
+   }
+   Init(*tConfiguration.FirstChildElement());
+}
+
+
+void CSurrogateEngine::Init(TConfigurationNode& t_root) {
+   try {
+      m_ptRoot = &t_root;
+      ParseFramework(t_root);
+      m_cRules.Init(GetNode(GetNode(t_root, "loop_functions"), "foraging"),
+                    m_pcRNG, m_strOutputOverride);
+      ParseArena(GetNode(t_root, "arena"));
+      m_cRules.SetArena(m_cArenaMin, m_cArenaMax);
+      m_ptRoot = NULL;
+      /* consultas de vizinhança: para colisões e proximidade a célula é o
+       * alcance da consulta; o alcance do range and bearing cobre 3 células */
+      m_cNearGrid.Init(m_cArenaMin, m_cArenaMax, 2.0f * FOOTBOT_RADIUS + PROXIMITY_RANGE);
+      m_cRABGrid.Init(m_cArenaMin, m_cArenaMax, RAB_CELL_SIZE);
+      /* nenhuma consulta devolve mais vizinhos que o total de robôs */
+      m_vecNeighbours.reserve(m_vecRobots.size());
+      InitRAB();
+      m_unClock = 0;
+      Sense();
+      ResetPhaseTimes();
+   }
+   catch(CARGoSException& ex) {
+      m_ptRoot = NULL;
+      THROW_ARGOSEXCEPTION_NESTED("Error initializing the surrogate engine", ex);
+   }
+}
+
+
+void CSurrogateEngine::ParseFramework(TConfigurationNode& t_root) {
+   TConfigurationNode& tExperiment = GetNode(GetNode(t_root, "framework"), "experiment");
+   Real fLength;
+   UInt32 unTicksPerSecond;
+   GetNodeAttribute(tExperiment, "length", fLength);
+   GetNodeAttribute(tExperiment, "ticks_per_second", unTicksPerSecond);
+   m_fTickLength = 1.0f / unTicksPerSecond;
+   /* no .argos o tempo é dado em segundos */
+   m_unLength = static_cast<UInt32>(fLength * unTicksPerSecond);
+   if(m_unLengthOverride > 0) {
+      m_unLength = m_unLengthOverride;
+   }
+   if(! m_bSeedSet) {
+      GetNodeAttributeOrDefault(tExperiment, "random_seed", m_unRandomSeed, m_unRandomSeed);
+      if(m_unRandomSeed == 0) {
+         m_unRandomSeed = static_cast<UInt32>(::time(NULL));
+      }
+   }
+   if(CRandom::ExistsCategory("argos")) {
+      CRandom::RemoveCategory("argos");
+   }
+   CRandom::CreateCategory("argos", m_unRandomSeed);
+   m_pcRNG = CRandom::CreateRNG("argos");
+}
+
+void CSurrogateEngine::ParseArena(TConfigurationNode& t_arena) {
+   CVector3 cSize, cCenter;
+   GetNodeAttribute(t_arena, "size", cSize);
+   GetNodeAttributeOrDefault(t_arena, "center", cCenter, cCenter);
+   m_cArenaMin.Set(cCenter.GetX() - cSize.GetX() * 0.5f, cCenter.GetY() - cSize.GetY() * 0.5f);
+   m_cArenaMax.Set(cCenter.GetX() + cSize.GetX() * 0.5f, cCenter.GetY() + cSize.GetY() * 0.5f);
+   TConfigurationNodeIterator itArena;
+   for(itArena = itArena.begin(&t_arena);
+       itArena != itArena.end();
+       ++itArena) {
+      if(itArena->Value() == "box") {
+         /* somente caixas alinhadas aos eixos (rotação múltipla de 90 graus) */
+         CVector3 cBoxSize, cPosition, cOrientation;
+         GetNodeAttribute(*itArena, "size", cBoxSize);
+         TConfigurationNode& tBody = GetNode(*itArena, "body");
+         GetNodeAttribute(tBody, "position", cPosition);
+         GetNodeAttributeOrDefault(tBody, "orientation", cOrientation, cOrientation);
+         SInt32 nQuarterTurns = static_cast<SInt32>(std::floor(cOrientation.GetX() / 90.0f + 0.5f));
+         if(Abs(cOrientation.GetX() - nQuarterTurns * 90.0f) > 1e-3f) {
+            THROW_ARGOSEXCEPTION("Box \"" << itArena->GetAttribute("id") << "\" is not axis-aligned");
+         }
+         if(nQuarterTurns % 2 != 0) {
+            cBoxSize.Set(cBoxSize.GetY(), cBoxSize.GetX(), cBoxSize.GetZ());
+         }
+         SBox sBox;
+         sBox.Min.Set(cPosition.GetX() - cBoxSize.GetX() * 0.5f, cPosition.GetY() - cBoxSize.GetY() * 0.5f);
+         sBox.Max.Set(cPosition.GetX() + cBoxSize.GetX() * 0.5f, cPosition.GetY() + cBoxSize.GetY() * 0.5f);
+         m_vecBoxes.push_back(sBox);
+      }
+      else if(itArena->Value() == "light") {
+         SLight sLight;
+         GetNodeAttribute(*itArena, "position", sLight.Position);
+         GetNodeAttribute(*itArena, "intensity", sLight.Intensity);
+         m_vecLights.push_back(sLight);
+      }
+      else if(itArena->Value() == "foot-bot") {
+         CVector3 cPosition, cOrientation;
+         TConfigurationNode& tBody = GetNode(*itArena, "body");
+         GetNodeAttribute(tBody, "position", cPosition);
+         GetNodeAttributeOrDefault(tBody, "orientation", cOrientation, cOrientation);
+         ParseFootBot(*itArena, itArena->GetAttribute("id"),
+                      cPosition.GetX(), cPosition.GetY(),
+                      ToRadians(CDegrees(cOrientation.GetX())).GetValue());
+      }
+      else if(itArena->Value() == "distribute") {
+         ParseDistribute(*itArena);
+      }
+   }
+}
+
+// <distribute>: apenas o método "uniform", que é o usado nos nossos cenários
+
+void CSurrogateEngine::ParseDistribute(TConfigurationNode& t_distribute) {
+   TConfigurationNode& tPosition = GetNode(t_distribute, "position");
+   TConfigurationNode& tOrientation = GetNode(t_distribute, "orientation");
+   TConfigurationNode& tEntity = GetNode(t_distribute, "entity");
+   std::string strMethod;
+   GetNodeAttribute(tPosition, "method", strMethod);
+   if(strMethod != "uniform") {
+      THROW_ARGOSEXCEPTION("Unsupported position distribution \"" << strMethod << "\"");
+   }
+   GetNodeAttribute(tOrientation, "method", strMethod);
+   if(strMethod != "uniform") {
+      THROW_ARGOSEXCEPTION("Unsupported orientation distribution \"" << strMethod << "\"");
+   }
+   CVector3 cPosMin, cPosMax, cOrientMin, cOrientMax;
+   GetNodeAttribute(tPosition, "min", cPosMin);
+   GetNodeAttribute(tPosition, "max", cPosMax);
+   GetNodeAttribute(tOrientation, "min", cOrientMin);
+   GetNodeAttribute(tOrientation, "max", cOrientMax);
+   UInt32 unQuantity, unMaxTrials;
+   GetNodeAttribute(tEntity, "quantity", unQuantity);
+   GetNodeAttribute(tEntity, "max_trials", unMaxTrials);
+   if(m_unNumRobotsOverride > 0) {
+      unQuantity = m_unNumRobotsOverride;
+   }
+   TConfigurationNode& tFootBot = GetNode(tEntity, "foot-bot");
+   std::string strBaseId;
+   GetNodeAttribute(tFootBot, "id", strBaseId);
+   CRange<Real> cRangeX(cPosMin.GetX(), cPosMax.GetX());
+   CRange<Real> cRangeY(cPosMin.GetY(), cPosMax.GetY());
+   CRange<Real> cRangeTheta(ToRadians(CDegrees(cOrientMin.GetX())).GetValue(),
+                            ToRadians(CDegrees(cOrientMax.GetX())).GetValue());
+   for(UInt32 i = 0; i < unQuantity; ++i) {
+      UInt32 unTrials = 0;
+      Real fX, fY;
+      do {
+         if(unTrials++ >= unMaxTrials) {
+            THROW_ARGOSEXCEPTION("Can't place " << strBaseId << i << ": max_trials exceeded");
+         }
+         fX = m_pcRNG->Uniform(cRangeX);
+         fY = m_pcRNG->Uniform(cRangeY);
+      } while(! IsFree(fX, fY));
+      std::ostringstream cId;
+      cId << strBaseId << i;
+      ParseFootBot(tFootBot, cId.str(), fX, fY, m_pcRNG->Uniform(cRangeTheta));
+   }
+}
+
+
+void CSurrogateEngine::ParseFootBot(TConfigurationNode& t_footbot, const std::string& str_id,
+                                    Real f_x, Real f_y, Real f_theta) {
+   std::string strConfig;
+   GetNodeAttribute(GetNode(t_footbot, "controller"), "config", strConfig);
+   AddRobot(str_id, FindControllerParams(strConfig), f_x, f_y, f_theta);
+}
+
+
+TConfigurationNode& CSurrogateEngine::FindControllerParams(const std::string& str_config) {
+   TConfigurationNode& tControllers = GetNode(*m_ptRoot, "controllers");
+   TConfigurationNodeIterator itController;
+   for(itController = itController.begin(&tControllers);
+       itController != itController.end();
+       ++itController) {
+      if(itController->GetAttribute("id") == str_config) {
+         return GetNode(*itController, "params");
+      }
+   }
+   THROW_ARGOSEXCEPTION("Controller config \"" << str_config << "\" not found");
+}
+
+
+bool CSurrogateEngine::IsFree(Real f_x, Real f_y) const {
+   Real fMinDist = 2.0f * FOOTBOT_RADIUS;
+   for(size_t i = 0; i < m_vecX.size(); ++i) {
+      Real fDX = m_vecX[i] - f_x, fDY = m_vecY[i] - f_y;
+      if(fDX * fDX + fDY * fDY < fMinDist * fMinDist) return false;
+   }
+   for(size_t i = 0; i < m_vecBoxes.size(); ++i) {
+      if(f_x > m_vecBoxes[i].Min.GetX() - FOOTBOT_RADIUS &&
+         f_x < m_vecBoxes[i].Max.GetX() + FOOTBOT_RADIUS &&
+         f_y > m_vecBoxes[i].Min.GetY() - FOOTBOT_RADIUS &&
+         f_y < m_vecBoxes[i].Max.GetY() + FOOTBOT_RADIUS) return false;
+   }
+   return true;
+}
+
+// cria um robô: controlador real + dispositivos do substituto
+
+void CSurrogateEngine::AddRobot(const std::string& str_id, TConfigurationNode& t_params,
+                                Real f_x, Real f_y, Real f_theta) {
+   size_t unIndex = m_vecRobots.size();
+   m_vecX.push_back(f_x);
+   m_vecY.push_back(f_y);
+   m_vecTheta.push_back(f_theta);
+   m_vecLeftSpeed.push_back(0.0f);
+   m_vecRightSpeed.push_back(0.0f);
+   SRobot sRobot;
+   sRobot.Wheels    = new CSurrogateWheels(m_vecLeftSpeed, m_vecRightSpeed, unIndex);
+   sRobot.LEDs      = new CSurrogateLEDs;
+   sRobot.RABA      = new CSurrogateRABActuator;
+   sRobot.RABS      = new CSurrogateRABSensor;
+   sRobot.Proximity = new CSurrogateProximitySensor;
+   sRobot.Light     = new CSurrogateLightSensor;
+   sRobot.Ground    = new CSurrogateGroundSensor;
+   sRobot.Controller = new FootBotTrack;
+   sRobot.Controller->SetId(str_id);
+   sRobot.Controller->AddActuator("differential_steering", sRobot.Wheels);
+   sRobot.Controller->AddActuator("leds",                  sRobot.LEDs);
+   sRobot.Controller->AddActuator("range_and_bearing",     sRobot.RABA);
+   sRobot.Controller->AddSensor  ("range_and_bearing",     sRobot.RABS);
+   sRobot.Controller->AddSensor  ("footbot_proximity",     sRobot.Proximity);
+   sRobot.Controller->AddSensor  ("footbot_light",         sRobot.Light);
+   sRobot.Controller->AddSensor  ("footbot_motor_ground",  sRobot.Ground);
+   m_vecRobots.push_back(sRobot);
+   sRobot.Controller->Init(t_params);
+}
+
+
+void CSurrogateEngine::Destroy() {
+   for(size_t i = 0; i < m_vecRobots.size(); ++i) {
+      m_vecRobots[i].Controller->Destroy();
+      delete m_vecRobots[i].Controller;
+      delete m_vecRobots[i].Wheels;
+      delete m_vecRobots[i].LEDs;
+      delete m_vecRobots[i].RABA;
+      delete m_vecRobots[i].RABS;
+      delete m_vecRobots[i].Proximity;
+      delete m_vecRobots[i].Light;
+      delete m_vecRobots[i].Ground;
+   }
+   m_vecRobots.clear();
+   m_vecRABPackets.clear();
+   m_vecRABData.clear();
+   m_vecRABDue.clear();
+   m_vecX.clear();
+   m_vecY.clear();
+   m_vecTheta.clear();
+   m_vecLeftSpeed.clear();
+   m_vecRightSpeed.clear();
+   m_vecBoxes.clear();
+   m_vecLights.clear();
+   m_cRules.Destroy();
+   /* os geradores dos controladores pertencem à categoria */
+   if(m_pcRNG != NULL) {
+      CRandom::RemoveCategory("argos");
+      m_pcRNG = NULL;
+   }
+}
+
+// mesma ordem do ARGoS: loop functions, controladores, física e sensores
+
+void CSurrogateEngine::Step() {
+   ++m_unClock;
+   SwitchPhase(PHASE_LOOP);
+   LoopPreStep();
+   SwitchPhase(PHASE_CONTROL);
+   ControlStep();
+   SwitchPhase(PHASE_PHYSICS);
+   Integrate();
+   ResolveCollisions();
+   SwitchPhase(PHASE_SENSE);
+   Sense();
+   SwitchPhase(NUM_PHASES);
+}
+
+
+void CSurrogateEngine::Execute() {
+   while(! IsExperimentFinished()) {
+      Step();
+   }
+}
+
+
+bool CSurrogateEngine::IsExperimentFinished() const {
+   if(m_unLength > 0) {
+      return m_unClock >= m_unLength;
+   }
+   return m_cRules.GetStatistics().Detected >= m_cRules.GetNumTargets();
+}
+
+const char* CSurrogateEngine::GetPhaseName(EPhase e_phase) {
+   static const char* PHASE_NAMES[NUM_PHASES] = { "loop", "control", "physics", "sense" };
+   return PHASE_NAMES[e_phase];
+}
+
+
+void CSurrogateEngine::ResetPhaseTimes() {
+   for(UInt32 i = 0; i < NUM_PHASES; ++i) {
+      m_pfPhaseTime[i] = 0.0f;
+   }
+}
+
+
+void CSurrogateEngine::SwitchPhase(EPhase e_phase) {
+   timespec tNow;
+   ::clock_gettime(CLOCK_MONOTONIC, &tNow);
+   double fNow = tNow.tv_sec + tNow.tv_nsec * 1e-9;
+   if(m_ePhase != NUM_PHASES) {
+      m_pfPhaseTime[m_ePhase] += fNow - m_fPhaseStart;
+   }
+   m_ePhase = e_phase;
+   m_fPhaseStart = fNow;
+   CAllocationCounter::SetPhase(e_phase);
+}
+
+// mesmo laço de CTrackingLoopFunctions::PreStep()
+
+void CSurrogateEngine::LoopPreStep() {
+   m_cRules.BeginStep();
+   for(size_t i = 0; i < m_vecRobots.size(); ++i) {
+      m_cRules.Visit(i, *m_vecRobots[i].Controller, CVector2(m_vecX[i], m_vecY[i]),
+                     CRadians(m_vecTheta[i]), m_unClock);
+   }
+   m_cRules.EndStep(m_unClock);
+}
+
+
+/*
+ * Os pacotes de range and bearing são montados logo antes do ControlStep()
+ * de cada robô e devolvidos logo depois: assim um vetor pronto por número de
+ * pacotes basta para o enxame todo, sem alocar quando a densidade muda.
+ */
+
+void CSurrogateEngine::ControlStep() {
+   for(size_t i = 0; i < m_vecRobots.size(); ++i) {
+      if(! m_vecRABDue[i]) {
+         m_vecRobots[i].Controller->ControlStep();
+         continue;
+      }
+      SwitchPhase(PHASE_SENSE);
+      SenseRAB(i);
+      SwitchPhase(PHASE_CONTROL);
+      m_vecRobots[i].Controller->ControlStep();
+      CCI_RangeAndBearingSensor::TReadings& tPackets = m_vecRobots[i].RABS->GetMutableReadings();
+      tPackets.swap(m_vecRABPackets[tPackets.size()]);
+   }
+}
+
+// cinemática de tração diferencial, passo fixo (velocidades das rodas em cm/s)
+
+void CSurrogateEngine::Integrate() {
+   const size_t unCount = m_vecX.size();
+   if(unCount == 0) return;
+   const Real fDT = m_fTickLength;
+   const Real fLinear = 0.01f * 0.5f * fDT;
+   const Real fAngular = 0.01f * fDT / FOOTBOT_INTERWHEEL;
+   Real* __restrict__ pfX = &m_vecX[0];
+   Real* __restrict__ pfY = &m_vecY[0];
+   Real* __restrict__ pfTheta = &m_vecTheta[0];
+   const Real* __restrict__ pfLeft = &m_vecLeftSpeed[0];
+   const Real* __restrict__ pfRight = &m_vecRightSpeed[0];
+   for(size_t i = 0; i < unCount; ++i) {
+      Real fDist = (pfLeft[i] + pfRight[i]) * fLinear;
+      Real fTurn = (pfRight[i] - pfLeft[i]) * fAngular;
+      /* integra com o ângulo no meio do passo */
+      Real fMid = pfTheta[i] + 0.5f * fTurn;
+      pfX[i] += fDist * std::cos(fMid);
+      pfY[i] += fDist * std::sin(fMid);
+      pfTheta[i] += fTurn;
+   }
+}
+
+// separa robôs sobrepostos e empurra-os para fora das paredes
+
+void CSurrogateEngine::ResolveCollisions() {
+   const size_t unCount = m_vecX.size();
+   if(unCount == 0) return;
+   const Real fMinDist = 2.0f * FOOTBOT_RADIUS;
+   m_cNearGrid.Build(&m_vecX[0], &m_vecY[0], unCount);
+   SNeighbourCollector sCollector;
+   sCollector.Buffer = &m_vecNeighbours;
+   for(size_t i = 0; i < unCount; ++i) {
+      m_vecNeighbours.clear();
+      m_cNearGrid.ForEachNear(m_vecX[i], m_vecY[i], fMinDist, sCollector);
+      for(size_t k = 0; k < m_vecNeighbours.size(); ++k) {
+         size_t j = m_vecNeighbours[k];
+         if(j <= i) continue;
+         Real fDX = m_vecX[j] - m_vecX[i], fDY = m_vecY[j] - m_vecY[i];
+         Real fSq = fDX * fDX + fDY * fDY;
+         if(fSq >= fMinDist * fMinDist) continue;
+         if(fSq > 0.0f) {
+            Real fDist = std::sqrt(fSq);
+            Real fPush = 0.5f * (fMinDist - fDist) / fDist;
+            m_vecX[i] -= fDX * fPush; m_vecY[i] -= fDY * fPush;
+            m_vecX[j] += fDX * fPush; m_vecY[j] += fDY * fPush;
+         }
+         else {
+            /* mesma posição: sem direção, separa ao longo de x (i para -x, j para +x) */
+            m_vecX[i] -= 0.5f * fMinDist;
+            m_vecX[j] += 0.5f * fMinDist;
+         }
+      }
+      for(size_t b = 0; b < m_vecBoxes.size(); ++b) {
+         const SBox& sBox = m_vecBoxes[b];
+         Real fCX = Max(sBox.Min.GetX(), Min(m_vecX[i], sBox.Max.GetX()));
+         Real fCY = Max(sBox.Min.GetY(), Min(m_vecY[i], sBox.Max.GetY()));
+         Real fDX = m_vecX[i] - fCX, fDY = m_vecY[i] - fCY;
+         Real fSq = fDX * fDX + fDY * fDY;
+         if(fSq >= FOOTBOT_RADIUS * FOOTBOT_RADIUS) continue;
+         if(fSq > 0.0f) {
+            Real fDist = std::sqrt(fSq);
+            m_vecX[i] += fDX * (FOOTBOT_RADIUS - fDist) / fDist;
+            m_vecY[i] += fDY * (FOOTBOT_RADIUS - fDist) / fDist;
+            continue;
+         }
+         /* centro dentro da caixa: sai pela face mais próxima (empate: -x, +x, -y, +y) */
+         Real pfDepth[4] = {
+            m_vecX[i] - sBox.Min.GetX(), sBox.Max.GetX() - m_vecX[i],
+            m_vecY[i] - sBox.Min.GetY(), sBox.Max.GetY() - m_vecY[i]
+         };
+         UInt32 unFace = 0;
+         for(UInt32 f = 1; f < 4; ++f) {
+            if(pfDepth[f] < pfDepth[unFace]) unFace = f;
+         }
+         switch(unFace) {
+            case 0:  m_vecX[i] = sBox.Min.GetX() - FOOTBOT_RADIUS; break;
+            case 1:  m_vecX[i] = sBox.Max.GetX() + FOOTBOT_RADIUS; break;
+            case 2:  m_vecY[i] = sBox.Min.GetY() - FOOTBOT_RADIUS; break;
+            default: m_vecY[i] = sBox.Max.GetY() + FOOTBOT_RADIUS; break;
+         }
+      }
+   }
+}
+
+// Atualiza somente os sensores que o estado atual do controlador lê:
+// descanso -> range and bearing (pacotes montados no ControlStep() seguinte);
+// exploração -> proximidade, chão e luz (no ninho); retorno ao ninho -> chão
+
+void CSurrogateEngine::Sense() {
+   const size_t unCount = m_vecX.size();
+   if(unCount == 0) return;
+   m_cNearGrid.Build(&m_vecX[0], &m_vecY[0], unCount);
+   m_cRABGrid.Build(&m_vecX[0], &m_vecY[0], unCount);
+   for(size_t i = 0; i < unCount; ++i) {
+      FootBotTrack& cController = *m_vecRobots[i].Controller;
+      /* cópia do pacote deste passo: no ControlStep() seguinte os vizinhos
+       * o leem mesmo depois que o robô já tiver escrito um novo */
+      m_vecRABData[i] = m_vecRobots[i].RABA->GetPacketData();
+      m_vecRABDue[i] = cController.IsResting();
+      if(! cController.IsResting()) {
+         SenseGround(i);
+         if(cController.IsExploring()) {
+            SenseProximity(i);
+            SenseLight(i);
+         }
+      }
+   }
+}
+
+
+Real CSurrogateEngine::FloorValue(Real f_x, Real f_y) const {
+   /* mesmas cores de CTrackingRules::GetFloorColor() em tons de cinza */
+   CVector2 cPos(f_x, f_y);
+   if(m_cRules.IsInNest(cPos)) {
+      return 0.5f;
+   }
+   if(m_cRules.IsOnTarget(cPos)) {
+      return 0.0f;
+   }
+   return 1.0f;
+}
+
+
+void CSurrogateEngine::SenseGround(size_t un_robot) {
+   CCI_FootBotMotorGroundSensor::TReadings& tReads = m_vecRobots[un_robot].Ground->GetMutableReadings();
+   Real fCos = std::cos(m_vecTheta[un_robot]), fSin = std::sin(m_vecTheta[un_robot]);
+   for(size_t i = 0; i < tReads.size(); ++i) {
+      /* os offsets dos sensores de chão são dados em cm */
+      Real fOX = tReads[i].Offset.GetX() * 0.01f, fOY = tReads[i].Offset.GetY() * 0.01f;
+      tReads[i].Value = FloorValue(m_vecX[un_robot] + fCos * fOX - fSin * fOY,
+                                   m_vecY[un_robot] + fSin * fOX + fCos * fOY);
+   }
+}
+
+
+void CSurrogateEngine::SenseLight(size_t un_robot) {
+   CCI_FootBotLightSensor::TReadings& tReads = m_vecRobots[un_robot].Light->GetMutableReadings();
+   for(size_t i = 0; i < tReads.size(); ++i) {
+      tReads[i].Value = 0.0f;
+   }
+   /* o controlador só usa a luz dentro do ninho */
+   if(! m_cRules.IsInNest(CVector2(m_vecX[un_robot] - FOOTBOT_RADIUS, 0.0f))) return;
+   const Real fSensorSpacing = ARGOS_PI * 2.0f / tReads.size();
+   const Real fFirstAngle = tReads[0].Angle.GetValue();
+   for(size_t l = 0; l < m_vecLights.size(); ++l) {
+      Real fDX = m_vecLights[l].Position.GetX() - m_vecX[un_robot];
+      Real fDY = m_vecLights[l].Position.GetY() - m_vecY[un_robot];
+      Real fDZ = m_vecLights[l].Position.GetZ() - FOOTBOT_LIGHT_HEIGHT;
+      Real fSqDist = fDX * fDX + fDY * fDY + fDZ * fDZ;
+      /* intensidade cai com o quadrado da distância */
+      Real fValue = m_vecLights[l].Intensity * m_vecLights[l].Intensity / fSqDist;
+      CRadians cBearing(std::atan2(fDY, fDX) - m_vecTheta[un_robot] - fFirstAngle);
+      cBearing.UnsignedNormalize();
+      size_t unIdx = static_cast<size_t>(cBearing.GetValue() / fSensorSpacing + 0.5f) % tReads.size();
+      tReads[unIdx].Value += fValue;
+   }
+}
+
+// proximidade: cada sensor é um raio de 10 cm partindo da borda do robô
+
+void CSurrogateEngine::SenseProximity(size_t un_robot) {
+   CCI_FootBotProximitySensor::TReadings& tReads = m_vecRobots[un_robot].Proximity->GetMutableReadings();
+   SNeighbourCollector sCollector;
+   sCollector.Buffer = &m_vecNeighbours;
+   m_vecNeighbours.clear();
+   m_cNearGrid.ForEachNear(m_vecX[un_robot], m_vecY[un_robot],
+                           2.0f * FOOTBOT_RADIUS + PROXIMITY_RANGE, sCollector);
+   CVector2 cCenter(m_vecX[un_robot], m_vecY[un_robot]);
+   for(size_t i = 0; i < tReads.size(); ++i) {
+      Real fAngle = m_vecTheta[un_robot] + tReads[i].Angle.GetValue();
+      CVector2 cDirection(std::cos(fAngle), std::sin(fAngle));
+      Real fDistance = CastRay(cCenter + cDirection * FOOTBOT_RADIUS, cDirection,
+                               PROXIMITY_RANGE, un_robot);
+      /* curva de resposta do sensor de proximidade do foot-bot */
+      tReads[i].Value = (fDistance < PROXIMITY_RANGE) ?
+         Min<Real>(1.0f, 0.0100527f / (fDistance + 0.000163144f)) :
+         0.0f;
+   }
+}
+
+// distância até o primeiro obstáculo (robôs em m_vecNeighbours ou caixas), ou f_length
+
+Real CSurrogateEngine::CastRay(const CVector2& c_origin, const CVector2& c_direction,
+                               Real f_length, size_t un_robot) const {
+   Real fBest = f_length;
+   for(size_t k = 0; k < m_vecNeighbours.size(); ++k) {
+      size_t j = m_vecNeighbours[k];
+      if(j == un_robot) continue;
+      Real fMX = c_origin.GetX() - m_vecX[j], fMY = c_origin.GetY() - m_vecY[j];
+      Real fB = fMX * c_direction.GetX() + fMY * c_direction.GetY();
+      Real fC = fMX * fMX + fMY * fMY - FOOTBOT_RADIUS * FOOTBOT_RADIUS;
+      if(fC < 0.0f) return 0.0f;
+      Real fDisc = fB * fB - fC;
+      if(fDisc < 0.0f) continue;
+      Real fT = -fB - std::sqrt(fDisc);
+      if(fT >= 0.0f && fT < fBest) fBest = fT;
+   }
+   for(size_t b = 0; b < m_vecBoxes.size(); ++b) {
+      /* teste de placas (slab) do raio contra a caixa */
+      const SBox& sBox = m_vecBoxes[b];
+      Real fTMin = 0.0f, fTMax = fBest;
+      bool bHit = true;
+      for(UInt32 unAxis = 0; unAxis < 2 && bHit; ++unAxis) {
+         Real fO = unAxis == 0 ? c_origin.GetX() : c_origin.GetY();
+         Real fD = unAxis == 0 ? c_direction.GetX() : c_direction.GetY();
+         Real fLo = unAxis == 0 ? sBox.Min.GetX() : sBox.Min.GetY();
+         Real fHi = unAxis == 0 ? sBox.Max.GetX() : sBox.Max.GetY();
+         if(Abs(fD) < 1e-9f) {
+            bHit = (fO >= fLo && fO <= fHi);
+         }
+         else {
+            Real fT1 = (fLo - fO) / fD, fT2 = (fHi - fO) / fD;
+            if(fT1 > fT2) std::swap(fT1, fT2);
+            fTMin = Max(fTMin, fT1);
+            fTMax = Min(fTMax, fT2);
+            bHit = fTMin <= fTMax;
+         }
+      }
+      if(bHit && fTMin < fBest) fBest = fTMin;
+   }
+   return fBest;
+}
+
+// range and bearing: prepara um vetor pronto para cada número de pacotes
+
+void CSurrogateEngine::InitRAB() {
+   /*
+    * Cada Data é uma alocação: todos os pacotes são criados aqui, de 0 até
+    * o total de robôs - 1 vizinhos, e depois só reescritos no lugar. São
+    * n(n-1)/2 pacotes (cerca de 40 MB para 1000 robôs).
+    */
+   const size_t unCount = m_vecRobots.size();
+   CCI_RangeAndBearingSensor::SPacket sPacket;
+   sPacket.Range = 0.0f;
+   sPacket.Data.Resize(CSurrogateRABActuator::DATA_SIZE);
+   m_vecRABPackets.resize(unCount);
+   for(size_t k = 0; k < unCount; ++k) {
+      m_vecRABPackets[k].assign(k, sPacket);
+   }
+   m_vecRABData.assign(unCount, sPacket.Data);
+   m_vecRABDue.assign(unCount, 0);
+}
+
+// range and bearing: pacotes de todos os robôs dentro do alcance
+
+void CSurrogateEngine::SenseRAB(size_t un_robot) {
+   /* uma leitura por vizinho no alcance, como no ARGoS; as posições não
+    * mudaram desde Sense(), então a grade construída lá continua valendo */
+   SNeighbourCollector sCollector;
+   sCollector.Buffer = &m_vecNeighbours;
+   m_vecNeighbours.clear();
+   m_cRABGrid.ForEachNear(m_vecX[un_robot], m_vecY[un_robot], RAB_RANGE, sCollector);
+   size_t unPackets = 0;
+   for(size_t k = 0; k < m_vecNeighbours.size(); ++k) {
+      size_t j = m_vecNeighbours[k];
+      if(j == un_robot) continue;
+      Real fDX = m_vecX[j] - m_vecX[un_robot], fDY = m_vecY[j] - m_vecY[un_robot];
+      if(fDX * fDX + fDY * fDY > RAB_RANGE * RAB_RANGE) continue;
+      m_vecNeighbours[unPackets++] = j;
+   }
+   /* o vetor pronto com unPackets pacotes vai para o robô até o fim do seu
+    * ControlStep(); fora dele as leituras do robô ficam vazias */
+   CCI_RangeAndBearingSensor::TReadings& tPackets = m_vecRobots[un_robot].RABS->GetMutableReadings();
+   tPackets.swap(m_vecRABPackets[unPackets]);
+   for(size_t k = 0; k < unPackets; ++k) {
+      size_t j = m_vecNeighbours[k];
+      Real fDX = m_vecX[j] - m_vecX[un_robot], fDY = m_vecY[j] - m_vecY[un_robot];
+      CCI_RangeAndBearingSensor::SPacket& sPacket = tPackets[k];
+      /* o range and bearing do ARGoS mede a distância em cm */
+      sPacket.Range = std::sqrt(fDX * fDX + fDY * fDY) * 100.0f;
+      sPacket.HorizontalBearing = CRadians(std::atan2(fDY, fDX) - m_vecTheta[un_robot]).SignedNormalize();
+      sPacket.VerticalBearing = CRadians::ZERO;
+      sPacket.Data = m_vecRABData[j];
+   }
+}
@@ -0,0 +1,228 @@
+#ifndef SURROGATE_ENGINE_H
+#define SURROGATE_ENGINE_H
+
+/*
+ * Motor substituto (surrogate) para varreduras rápidas de parâmetros.
+ *
+ * Lê o mesmo arquivo .argos do experimento, cria um FootBotTrack por robô
+ * (a lógica de decisão é exatamente a do controlador) e substitui o motor
+ * dynamics2d e os sensores simulados por:
+ *  - cinemática de tração diferencial integrada com passo fixo sobre vetores
+ *    contíguos (x, y, ângulo, rodas), um por grandeza, para o compilador vetorizar;
+ *  - sensores aproximados analiticamente a partir das posições (raios contra
+ *    círculos/caixas para proximidade, inverso do quadrado para luz, cor do
+ *    chão para o sensor de chão e alcance fixo para range and bearing);
+ *  - grade espacial para as consultas de vizinhança.
+ *
+ * As regras de CTrackingLoopFunctions (alvos, energia e saída) vêm do mesmo
+ * CTrackingRules usado no ARGoS, com o mesmo formato de arquivo de saída.
+ */
+
+#include "surrogate_devices.h"
+#include "surrogate_grid.h"
+#include <footbot_tracking/footbot_tracking.h>
+#include <loop_functions/tracking_rules.h>
+#include <argos3/core/utility/configuration/argos_configuration.h>
+#include <argos3/core/utility/math/rng.h>
+#include <argos3/core/utility/math/vector3.h>
+#include <string>
+#include <vector>
+
+using namespace argos;
+
+class CSurrogateEngine {
+
+public:
+
+   typedef CTrackingRules::SStatistics SStatistics;
+
+   /* fases de um passo, na ordem em que são executadas */
+   enum EPhase {
+      PHASE_LOOP = 0,      // regras das loop functions
+      PHASE_CONTROL,       // ControlStep() dos controladores
+      PHASE_PHYSICS,       // cinemática e colisões
+      PHASE_SENSE,         // leituras dos sensores
+      NUM_PHASES
+   };
+
+public:
+
+   CSurrogateEngine();
+   ~CSurrogateEngine();
+
+   /* Parâmetros que sobrescrevem o arquivo .argos, devem ser chamados antes de Init() */
+   inline void SetRandomSeed(UInt32 un_seed) {
+      m_unRandomSeed = un_seed;
+      m_bSeedSet = true;
+   }
+
+   inline void SetNumRobots(UInt32 un_robots) {
+      m_unNumRobotsOverride = un_robots;
+   }
+
+   inline void SetLength(UInt32 un_ticks) {
+      m_unLengthOverride = un_ticks;
+   }
+
+   inline void SetOutputFile(const std::string& str_output) {
+      m_strOutputOverride = str_output;
+   }
+
+   /* carrega o arquivo de experimento e cria o enxame */
+   void Init(const std::string& str_experiment_file);
+   /* idem, a partir da raiz <argos-configuration> já carregada */
+   void Init(TConfigurationNode& t_root);
+   /* executa um passo de controle */
+   void Step();
+   /* executa até IsExperimentFinished() */
+   void Execute();
+   /* termina quando acaba o tempo, ou (sem tempo definido) quando todos os alvos forem encontrados */
+   bool IsExperimentFinished() const;
+   void Destroy();
+
+   inline UInt32 GetSimulationClock() const {
+      return m_unClock;
+   }
+
+   inline size_t GetNumRobots() const {
+      return m_vecRobots.size();
+   }
+
+   inline FootBotTrack& GetController(size_t un_robot) {
+      return *m_vecRobots[un_robot].Controller;
+   }
+
+   inline CVector2 GetPosition(size_t un_robot) const {
+      return CVector2(m_vecX[un_robot], m_vecY[un_robot]);
+   }
+
+   inline const SStatistics& GetStatistics() const {
+      return m_cRules.GetStatistics();
+   }
+
+   /* tempo acumulado em cada fase desde Init() ou ResetPhaseTimes(), em segundos */
+   inline Real GetPhaseTime(EPhase e_phase) const {
+      return m_pfPhaseTime[e_phase];
+   }
+
+   static const char* GetPhaseName(EPhase e_phase);
+
+   void ResetPhaseTimes();
+
+private:
+
+   /* dispositivos de um robô (a posição e as rodas ficam nos vetores abaixo) */
+   struct SRobot {
+      FootBotTrack* Controller;
+      CSurrogateWheels* Wheels;
+      CSurrogateLEDs* LEDs;
+      CSurrogateRABActuator* RABA;
+      CSurrogateRABSensor* RABS;
+      CSurrogateProximitySensor* Proximity;
+      CSurrogateLightSensor* Light;
+      CSurrogateGroundSensor* Ground;
+   };
+
+   /* caixas alinhadas aos eixos (paredes) */
+   struct SBox {
+      CVector2 Min;
+      CVector2 Max;
+   };
+
+   struct SLight {
+      CVector3 Position;
+      Real Intensity;
+   };
+
+   /* coleta os vizinhos encontrados pela grade */
+   struct SNeighbourCollector {
+      std::vector<UInt32>* Buffer;
+      void operator()(UInt32 un_robot) {
+         Buffer->push_back(un_robot);
+      }
+   };
+
+private:
+
+   void ParseFramework(TConfigurationNode& t_root);
+   void ParseArena(TConfigurationNode& t_arena);
+   void ParseDistribute(TConfigurationNode& t_distribute);
+   void ParseFootBot(TConfigurationNode& t_footbot, const std::string& str_id,
+                     Real f_x, Real f_y, Real f_theta);
+   void AddRobot(const std::string& str_id, TConfigurationNode& t_params,
+                 Real f_x, Real f_y, Real f_theta);
+   bool IsFree(Real f_x, Real f_y) const;
+   TConfigurationNode& FindControllerParams(const std::string& str_config);
+
+   /* fecha a fase atual, somando seu tempo, e abre e_phase (NUM_PHASES: nenhuma) */
+   void SwitchPhase(EPhase e_phase);
+
+   void LoopPreStep();
+   void ControlStep();
+   void Integrate();
+   void ResolveCollisions();
+   void Sense();
+
+   void SenseProximity(size_t un_robot);
+   void SenseGround(size_t un_robot);
+   void SenseLight(size_t un_robot);
+   void InitRAB();
+   void SenseRAB(size_t un_robot);
+   Real FloorValue(Real f_x, Real f_y) const;
+   Real CastRay(const CVector2& c_origin, const CVector2& c_direction,
+                Real f_length, size_t un_robot) const;
+
+private:
+
+   /* sobrescritas vindas da linha de comando */
+   UInt32 m_unRandomSeed;
+   bool m_bSeedSet;
+   UInt32 m_unNumRobotsOverride;
+   UInt32 m_unLengthOverride;
+   std::string m_strOutputOverride;
+
+   /* framework */
+   UInt32 m_unLength;
+   Real m_fTickLength;
+   UInt32 m_unClock;
+   CRandom::CRNG* m_pcRNG;
+
+   /* arena */
+   CVector2 m_cArenaMin, m_cArenaMax;
+   std::vector<SBox> m_vecBoxes;
+   std::vector<SLight> m_vecLights;
+
+   /* estado do enxame: um vetor por grandeza */
+   std::vector<SRobot> m_vecRobots;
+   std::vector<Real> m_vecX;
+   std::vector<Real> m_vecY;
+   std::vector<Real> m_vecTheta;
+   std::vector<Real> m_vecLeftSpeed;
+   std::vector<Real> m_vecRightSpeed;
+
+   /* consultas de vizinhança: proximidade/colisão e range and bearing */
+   CSurrogateGrid m_cNearGrid;
+   CSurrogateGrid m_cRABGrid;
+   mutable std::vector<UInt32> m_vecNeighbours;
+   /*
+    * Range and bearing: m_vecRABPackets[k] tem k pacotes prontos (de 0 ao
+    * total de robôs - 1), m_vecRABData guarda o pacote de cada robô no fim do
+    * passo e m_vecRABDue marca quem recebe pacotes no próximo ControlStep().
+    */
+   std::vector<CCI_RangeAndBearingSensor::TReadings> m_vecRABPackets;
+   std::vector<CByteArray> m_vecRABData;
+   std::vector<UInt8> m_vecRABDue;
+
+   /* raiz do experimento, válida somente durante Init() */
+   TConfigurationNode* m_ptRoot;
+
+   /* regras das loop functions */
+   CTrackingRules m_cRules;
+
+   /* tempo por fase */
+   EPhase m_ePhase;
+   double m_fPhaseStart;
+   Real m_pfPhaseTime[NUM_PHASES];
+};
+
+#endif
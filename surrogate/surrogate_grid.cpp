@@ -0,0 +1,46 @@
+#include "surrogate_grid.h"
+#include <algorithm>
+#include <cmath>
+
+CSurrogateGrid::CSurrogateGrid() :
+   m_fCellSize(1.0f),
+   m_fInvCellSize(1.0f),
+   m_nCellsX(1),
+   m_nCellsY(1) {}
+
+
+void CSurrogateGrid::Init(const CVector2& c_min, const CVector2& c_max, Real f_cell_size) {
+   m_cMin = c_min;
+   m_fCellSize = f_cell_size;
+   m_fInvCellSize = 1.0f / f_cell_size;
+   m_nCellsX = std::max<SInt32>(1, static_cast<SInt32>(std::ceil((c_max.GetX() - c_min.GetX()) * m_fInvCellSize)));
+   m_nCellsY = std::max<SInt32>(1, static_cast<SInt32>(std::ceil((c_max.GetY() - c_min.GetY()) * m_fInvCellSize)));
+   m_vecCellStart.assign(m_nCellsX * m_nCellsY + 1, 0);
+   m_vecItemCell.clear();
+   m_vecItems.clear();
+}
+
+
+void CSurrogateGrid::Build(const Real* pf_x, const Real* pf_y, size_t un_count) {
+   m_vecItemCell.resize(un_count);
+   m_vecItems.resize(un_count);
+   std::fill(m_vecCellStart.begin(), m_vecCellStart.end(), 0);
+   // conta quantos robôs há em cada célula
+   for(size_t i = 0; i < un_count; ++i) {
+      m_vecItemCell[i] = CellY(pf_y[i]) * m_nCellsX + CellX(pf_x[i]);
+      ++m_vecCellStart[m_vecItemCell[i] + 1];
+   }
+   // soma de prefixos -> início de cada célula
+   for(size_t i = 1; i < m_vecCellStart.size(); ++i) {
+      m_vecCellStart[i] += m_vecCellStart[i - 1];
+   }
+   // distribui os índices, usando o início de cada célula como cursor
+   for(size_t i = 0; i < un_count; ++i) {
+      m_vecItems[m_vecCellStart[m_vecItemCell[i]]++] = i;
+   }
+   // cada cursor parou no início da célula seguinte, desfaz o deslocamento
+   for(size_t i = m_vecCellStart.size() - 1; i > 0; --i) {
+      m_vecCellStart[i] = m_vecCellStart[i - 1];
+   }
+   m_vecCellStart[0] = 0;
+}
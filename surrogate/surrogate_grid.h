@@ -0,0 +1,93 @@
+#ifndef SURROGATE_GRID_H
+#define SURROGATE_GRID_H
+
+/*
+ * Grade espacial uniforme para consultas de vizinhança.
+ * É reconstruída a cada passo por contagem (counting sort), em O(robôs),
+ * e os vetores internos só alocam memória na primeira construção.
+ */
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+#include <argos3/core/utility/math/vector2.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace argos;
+
+class CSurrogateGrid {
+
+public:
+
+   CSurrogateGrid();
+
+   /* define a área coberta e o tamanho da célula */
+   void Init(const CVector2& c_min, const CVector2& c_max, Real f_cell_size);
+
+   /* reconstrói a grade a partir das coordenadas dos robôs */
+   void Build(const Real* pf_x, const Real* pf_y, size_t un_count);
+
+   inline Real GetCellSize() const {
+      return m_fCellSize;
+   }
+
+   inline SInt32 CellX(Real f_x) const {
+      return Clamp(static_cast<SInt32>((f_x - m_cMin.GetX()) * m_fInvCellSize), m_nCellsX);
+   }
+
+   inline SInt32 CellY(Real f_y) const {
+      return Clamp(static_cast<SInt32>((f_y - m_cMin.GetY()) * m_fInvCellSize), m_nCellsY);
+   }
+
+   /*
+    * Chama t_visit(índice) para todo robô nas células que tocam o círculo
+    * (x,y,r). Em cada linha só entram as colunas que a corda do círculo
+    * alcança, assim o raio pode ser várias células sem varrer o quadrado.
+    */
+   template<typename VISITOR>
+   void ForEachNear(Real f_x, Real f_y, Real f_radius, VISITOR& t_visit) const {
+      SInt32 nMinY = CellY(f_y - f_radius), nMaxY = CellY(f_y + f_radius);
+      for(SInt32 nY = nMinY; nY <= nMaxY; ++nY) {
+         /* distância em y até a faixa da linha; as linhas da borda também
+          * guardam os robôs de fora da área, então não têm limite externo */
+         Real fRowMin = m_cMin.GetY() + nY * m_fCellSize;
+         Real fDY = 0.0f;
+         if(nY > 0 && f_y < fRowMin) {
+            fDY = fRowMin - f_y;
+         }
+         else if(nY < m_nCellsY - 1 && f_y > fRowMin + m_fCellSize) {
+            fDY = f_y - fRowMin - m_fCellSize;
+         }
+         Real fHalf = std::sqrt(std::max<Real>(0.0f, f_radius * f_radius - fDY * fDY));
+         SInt32 nMinX = CellX(f_x - fHalf), nMaxX = CellX(f_x + fHalf);
+         for(SInt32 nX = nMinX; nX <= nMaxX; ++nX) {
+            size_t unCell = nY * m_nCellsX + nX;
+            for(UInt32 i = m_vecCellStart[unCell]; i < m_vecCellStart[unCell + 1]; ++i) {
+               t_visit(m_vecItems[i]);
+            }
+         }
+      }
+   }
+
+private:
+
+   inline static SInt32 Clamp(SInt32 n_cell, SInt32 n_cells) {
+      return n_cell < 0 ? 0 : (n_cell >= n_cells ? n_cells - 1 : n_cell);
+   }
+
+private:
+
+   CVector2 m_cMin;
+   Real m_fCellSize;
+   Real m_fInvCellSize;
+   SInt32 m_nCellsX;
+   SInt32 m_nCellsY;
+   /* início de cada célula em m_vecItems (tamanho células + 1) */
+   std::vector<UInt32> m_vecCellStart;
+   /* índice da célula de cada robô */
+   std::vector<UInt32> m_vecItemCell;
+   /* índices dos robôs ordenados por célula */
+   std::vector<UInt32> m_vecItems;
+};
+
+#endif
@@ -0,0 +1,121 @@
+/*
+ * Testes da grade de vizinhança do motor substituto: ForEachNear tem de
+ * devolver, sem repetir, todo robô a menos de f_radius, como a busca exaustiva.
+ */
+
+#include "surrogate_grid.h"
+#include <testing/unit_test.h>
+#include <algorithm>
+#include <iostream>
+
+/* gerador congruencial: o teste não depende da semente do ARGoS */
+static UInt32 s_unState = 12345;
+
+static Real Uniform(Real f_min, Real f_max) {
+   s_unState = s_unState * 1664525u + 1013904223u;
+   return f_min + (f_max - f_min) * (s_unState >> 8) / 16777216.0f;
+}
+
+/* quantas vezes cada robô foi visitado */
+struct SCounter {
+   std::vector<UInt32>* Visits;
+   void operator()(UInt32 un_robot) {
+      ++(*Visits)[un_robot];
+   }
+};
+
+/*
+ * Compara ForEachNear com a busca exaustiva para cada robô.
+ * Devolve o número de vizinhos (a menos de f_radius) que faltaram ou se repetiram.
+ */
+static UInt32 CompareWithBruteForce(const CSurrogateGrid& c_grid,
+                                    const std::vector<Real>& vec_x,
+                                    const std::vector<Real>& vec_y,
+                                    Real f_radius) {
+   UInt32 unBad = 0;
+   std::vector<UInt32> vecVisits(vec_x.size());
+   SCounter sCounter;
+   sCounter.Visits = &vecVisits;
+   for(size_t i = 0; i < vec_x.size(); ++i) {
+      std::fill(vecVisits.begin(), vecVisits.end(), 0);
+      c_grid.ForEachNear(vec_x[i], vec_y[i], f_radius, sCounter);
+      for(size_t j = 0; j < vec_x.size(); ++j) {
+         Real fDX = vec_x[i] - vec_x[j], fDY = vec_y[i] - vec_y[j];
+         if(vecVisits[j] > 1) ++unBad;
+         else if(fDX * fDX + fDY * fDY < f_radius * f_radius && vecVisits[j] == 0) ++unBad;
+      }
+   }
+   return unBad;
+}
+
+/****************************************/
+/****************************************/
+
+static void TestRandomSwarm() {
+   /* tamanho de célula que não divide a área: a última célula é parcial */
+   CSurrogateGrid cGrid;
+   cGrid.Init(CVector2(-5.0f, -5.0f), CVector2(5.0f, 5.0f), 0.27f);
+   const size_t unN = 2000;
+   std::vector<Real> vecX(unN), vecY(unN);
+   for(size_t i = 0; i < unN; ++i) {
+      vecX[i] = Uniform(-5.0f, 5.0f);
+      vecY[i] = Uniform(-5.0f, 5.0f);
+   }
+   /* reconstruída várias vezes, como a cada passo, com os robôs se movendo */
+   for(UInt32 unStep = 0; unStep < 3; ++unStep) {
+      cGrid.Build(&vecX[0], &vecY[0], unN);
+      CHECK(CompareWithBruteForce(cGrid, vecX, vecY, 0.27f) == 0);
+      /* raio menor que a célula também é válido */
+      CHECK(CompareWithBruteForce(cGrid, vecX, vecY, 0.1f) == 0);
+      /* raio de várias células, como o do range and bearing */
+      CHECK(CompareWithBruteForce(cGrid, vecX, vecY, 1.0f) == 0);
+      for(size_t i = 0; i < unN; ++i) {
+         vecX[i] += Uniform(-0.1f, 0.1f);
+         vecY[i] += Uniform(-0.1f, 0.1f);
+      }
+   }
+}
+
+
+static void TestOutsideAndShrink() {
+   /* robôs um pouco fora da área caem nas células da borda */
+   CSurrogateGrid cGrid;
+   cGrid.Init(CVector2(-1.0f, -1.0f), CVector2(1.0f, 1.0f), 0.5f);
+   std::vector<Real> vecX, vecY;
+   const Real pfPoints[][2] = {
+      { -1.05f, 0.0f }, { -0.9f, 0.0f }, { 1.02f, 1.02f }, { 0.9f, 0.9f },
+      { 0.0f, -1.2f }, { 0.0f, -0.8f }, { 0.0f, 0.0f }, { 0.3f, 0.1f },
+      /* ambos abaixo da área, na linha de baixo, a 0.473 um do outro */
+      { 0.45f, -1.3f }, { -0.02f, -1.25f }
+   };
+   for(size_t i = 0; i < sizeof(pfPoints) / sizeof(pfPoints[0]); ++i) {
+      vecX.push_back(pfPoints[i][0]);
+      vecY.push_back(pfPoints[i][1]);
+   }
+   cGrid.Build(&vecX[0], &vecY[0], vecX.size());
+   CHECK(CompareWithBruteForce(cGrid, vecX, vecY, 0.5f) == 0);
+   CHECK(CompareWithBruteForce(cGrid, vecX, vecY, 1.6f) == 0);
+   /* menos robôs que na construção anterior */
+   vecX.resize(3);
+   vecY.resize(3);
+   cGrid.Build(&vecX[0], &vecY[0], vecX.size());
+   CHECK(CompareWithBruteForce(cGrid, vecX, vecY, 0.5f) == 0);
+   /* grade vazia não visita ninguém */
+   std::vector<UInt32> vecVisits(10, 0);
+   SCounter sCounter;
+   sCounter.Visits = &vecVisits;
+   cGrid.Build(&vecX[0], &vecY[0], 0);
+   cGrid.ForEachNear(0.0f, 0.0f, 2.0f, sCounter);
+   for(size_t i = 0; i < vecVisits.size(); ++i) {
+      CHECK(vecVisits[i] == 0);
+   }
+}
+
+/****************************************/
+/****************************************/
+
+int main() {
+   TestRandomSwarm();
+   TestOutsideAndShrink();
+   return TestResult();
+}
@@ -0,0 +1,73 @@
+/*
+ * argos_surrogate: executa um experimento .argos no motor substituto.
+ *
+ * uso: argos_surrogate -c experimento.argos [-s semente] [-n robôs] [-l passos] [-o saída]
+ */
+
+#include "surrogate_engine.h"
+#include <argos3/core/utility/logging/argos_log.h>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+static void PrintUsage(const char* pch_program) {
+   LOGERR << "uso: " << pch_program
+          << " -c experimento.argos [-s semente] [-n robôs] [-l passos] [-o saída]"
+          << std::endl;
+}
+
+
+static Real Now() {
+   timespec tTime;
+   ::clock_gettime(CLOCK_MONOTONIC, &tTime);
+   return tTime.tv_sec + tTime.tv_nsec * 1e-9;
+}
+
+
+int main(int argc, char** argv) {
+   std::string strExperiment;
+   CSurrogateEngine cEngine;
+   for(int i = 1; i < argc; ++i) {
+      if(i + 1 >= argc) {
+         PrintUsage(argv[0]);
+         return 1;
+      }
+      if(::strcmp(argv[i], "-c") == 0)      strExperiment = argv[++i];
+      else if(::strcmp(argv[i], "-s") == 0) cEngine.SetRandomSeed(::strtoul(argv[++i], NULL, 10));
+      else if(::strcmp(argv[i], "-n") == 0) cEngine.SetNumRobots(::strtoul(argv[++i], NULL, 10));
+      else if(::strcmp(argv[i], "-l") == 0) cEngine.SetLength(::strtoul(argv[++i], NULL, 10));
+      else if(::strcmp(argv[i], "-o") == 0) cEngine.SetOutputFile(argv[++i]);
+      else {
+         PrintUsage(argv[0]);
+         return 1;
+      }
+   }
+   if(strExperiment.empty()) {
+      PrintUsage(argv[0]);
+      return 1;
+   }
+   try {
+      cEngine.Init(strExperiment);
+      Real fStart = Now();
+      cEngine.Execute();
+      Real fElapsed = Now() - fStart;
+      const CSurrogateEngine::SStatistics& sStats = cEngine.GetStatistics();
+      LOG << "robôs: " << cEngine.GetNumRobots()
+          << "  passos: " << cEngine.GetSimulationClock()
+          << "  passos/s: " << cEngine.GetSimulationClock() / fElapsed
+          << "  primeiro alvo: " << sStats.FirstDetection
+          << "  alvos: " << sStats.Detected
+          << "  energia: " << sStats.Energy
+          << std::endl;
+      cEngine.Destroy();
+   }
+   catch(CARGoSException& ex) {
+      LOGERR << ex.what() << std::endl;
+      LOG.Flush();
+      LOGERR.Flush();
+      return 1;
+   }
+   LOG.Flush();
+   LOGERR.Flush();
+   return 0;
+}
@@ -0,0 +1,119 @@
+/*
+ * surrogate_validate: compara as estatísticas de execuções do ARGoS com as
+ * do motor substituto nos mesmos cenários/sementes.
+ *
+ * uso: surrogate_validate [-t tolerância] argos_1.txt surrogate_1.txt [argos_2.txt surrogate_2.txt ...]
+ *
+ * Os arquivos são as saídas das loop functions (mesmo formato nos dois motores).
+ * Para cada motor calcula a média, sobre as execuções, de:
+ *  - fração de robôs fora do descanso;
+ *  - passo do primeiro alvo encontrado (execuções sem alvo contam o último passo);
+ *  - energia final por robô.
+ * Sai com código 1 se alguma diferença relativa passar da tolerância (padrão 0.25).
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+struct SRunSummary {
+   double WalkingFraction;
+   double FirstDetection;
+   double EnergyPerRobot;
+};
+
+
+static bool Summarize(const std::string& str_file, SRunSummary& s_summary) {
+   std::ifstream cInput(str_file.c_str());
+   if(! cInput) {
+      std::cerr << "não foi possível abrir " << str_file << std::endl;
+      return false;
+   }
+   std::string strLine;
+   double fWalkingSum = 0.0;
+   unsigned long unRows = 0, unClock = 0, unWalking = 0, unResting = 0, unFound = 0;
+   long nEnergy = 0;
+   long nFirstDetection = -1;
+   while(std::getline(cInput, strLine)) {
+      if(strLine.empty() || strLine[0] == '#') continue;
+      std::istringstream cRow(strLine);
+      if(!(cRow >> unClock >> unWalking >> unResting >> unFound >> nEnergy)) {
+         std::cerr << str_file << ": linha inválida \"" << strLine << "\"" << std::endl;
+         return false;
+      }
+      if(unWalking + unResting > 0) {
+         fWalkingSum += static_cast<double>(unWalking) / (unWalking + unResting);
+      }
+      if(unFound > 0 && nFirstDetection < 0) {
+         nFirstDetection = unClock;
+      }
+      ++unRows;
+   }
+   if(unRows == 0) {
+      std::cerr << str_file << ": arquivo vazio" << std::endl;
+      return false;
+   }
+   s_summary.WalkingFraction = fWalkingSum / unRows;
+   s_summary.FirstDetection = nFirstDetection < 0 ? unClock : nFirstDetection;
+   s_summary.EnergyPerRobot = static_cast<double>(nEnergy) / (unWalking + unResting);
+   return true;
+}
+
+
+static bool Compare(const char* pch_name, double f_argos, double f_surrogate, double f_tolerance) {
+   double fScale = std::max(std::fabs(f_argos), 1e-9);
+   double fDiff = std::fabs(f_surrogate - f_argos) / fScale;
+   bool bOk = fDiff <= f_tolerance;
+   std::cout << std::left << std::setw(24) << pch_name
+             << std::right << std::setw(14) << f_argos
+             << std::setw(14) << f_surrogate
+             << std::setw(10) << std::setprecision(3) << fDiff * 100.0 << "%"
+             << (bOk ? "" : "  <-- fora da tolerância") << std::endl;
+   return bOk;
+}
+
+
+int main(int argc, char** argv) {
+   double fTolerance = 0.25;
+   int nFirst = 1;
+   if(argc > 2 && ::strcmp(argv[1], "-t") == 0) {
+      fTolerance = ::atof(argv[2]);
+      nFirst = 3;
+   }
+   if(argc - nFirst < 2 || (argc - nFirst) % 2 != 0) {
+      std::cerr << "uso: " << argv[0]
+                << " [-t tolerância] argos_1.txt surrogate_1.txt [argos_2.txt surrogate_2.txt ...]"
+                << std::endl;
+      return 2;
+   }
+   SRunSummary sArgos = { 0.0, 0.0, 0.0 }, sSurrogate = { 0.0, 0.0, 0.0 };
+   int nRuns = (argc - nFirst) / 2;
+   for(int i = nFirst; i < argc; i += 2) {
+      SRunSummary sA, sS;
+      if(! Summarize(argv[i], sA) || ! Summarize(argv[i + 1], sS)) {
+         return 2;
+      }
+      sArgos.WalkingFraction += sA.WalkingFraction / nRuns;
+      sArgos.FirstDetection  += sA.FirstDetection / nRuns;
+      sArgos.EnergyPerRobot  += sA.EnergyPerRobot / nRuns;
+      sSurrogate.WalkingFraction += sS.WalkingFraction / nRuns;
+      sSurrogate.FirstDetection  += sS.FirstDetection / nRuns;
+      sSurrogate.EnergyPerRobot  += sS.EnergyPerRobot / nRuns;
+   }
+   std::cout << "execuções: " << nRuns << "  tolerância: " << fTolerance * 100.0 << "%" << std::endl;
+   std::cout << std::left << std::setw(24) << "# métrica"
+             << std::right << std::setw(14) << "argos"
+             << std::setw(14) << "surrogate"
+             << std::setw(11) << "diferença" << std::endl;
+   bool bOk = true;
+   bOk &= Compare("fração procurando", sArgos.WalkingFraction, sSurrogate.WalkingFraction, fTolerance);
+   bOk &= Compare("primeiro alvo (passo)", sArgos.FirstDetection, sSurrogate.FirstDetection, fTolerance);
+   bOk &= Compare("energia por robô", sArgos.EnergyPerRobot, sSurrogate.EnergyPerRobot, fTolerance);
+   return bOk ? 0 : 1;
+}
@@ -0,0 +1,51 @@
+#!/bin/sh
+# Compara o motor substituto com o ARGoS no mesmo cenário e nas mesmas sementes.
+#
+# uso (na raiz do repositório, depois de ./compile.sh):
+#   ./surrogate/validate.sh [experimento.argos] [passos] [tolerância] [sementes...]
+#
+# Também mede o tempo de parede de cada motor e falha (código 3) se a
+# aceleração do substituto ficar abaixo de MIN_SPEEDUP (padrão 10).
+
+EXPERIMENT=${1:-swarm_tracking.argos}
+TICKS=${2:-3000}
+TOLERANCE=${3:-0.25}
+if [ $# -ge 3 ]; then shift 3; else shift $#; fi
+SEEDS=${*:-"1 2 3 4 5"}
+MIN_SPEEDUP=${MIN_SPEEDUP:-10}
+
+OUT=build/validation
+mkdir -p $OUT
+TICKS_PER_SECOND=$(sed -n 's/.*ticks_per_second="\([0-9]*\)".*/\1/p' $EXPERIMENT)
+LENGTH=$((TICKS / TICKS_PER_SECOND))
+
+PAIRS=""
+ARGOS_TIME=0
+SURROGATE_TIME=0
+for SEED in $SEEDS; do
+   # mesma configuração, sem visualização, com semente/tempo/saída fixos
+   sed -e "s/random_seed=\"[0-9]*\"/random_seed=\"$SEED\"/" \
+       -e "s/ length=\"[0-9]*\"/ length=\"$LENGTH\"/" \
+       -e "s|output=\"[^\"]*\"|output=\"$OUT/argos_$SEED.txt\"|" \
+       -e '/<visualization>/,/<\/visualization>/d' \
+       $EXPERIMENT > $OUT/experiment_$SEED.argos
+   START=$(date +%s.%N)
+   argos3 -z -c $OUT/experiment_$SEED.argos || exit 2
+   MIDDLE=$(date +%s.%N)
+   build/surrogate/argos_surrogate -c $OUT/experiment_$SEED.argos -o $OUT/surrogate_$SEED.txt || exit 2
+   END=$(date +%s.%N)
+   ARGOS_TIME=$(echo "$ARGOS_TIME $START $MIDDLE" | awk '{ print $1 + $3 - $2 }')
+   SURROGATE_TIME=$(echo "$SURROGATE_TIME $MIDDLE $END" | awk '{ print $1 + $3 - $2 }')
+   PAIRS="$PAIRS $OUT/argos_$SEED.txt $OUT/surrogate_$SEED.txt"
+done
+
+build/surrogate/surrogate_validate -t $TOLERANCE $PAIRS
+STATUS=$?
+
+# tempo inclui a leitura do .argos e a criação das entidades nos dois motores
+echo "$ARGOS_TIME $SURROGATE_TIME $MIN_SPEEDUP" | awk '{
+   printf "tempo: argos %.2f s, surrogate %.2f s, aceleração %.1fx (mínimo %gx)\n",
+          $1, $2, $1 / ($2 > 0 ? $2 : 1e-9), $3
+   exit ($1 / ($2 > 0 ? $2 : 1e-9) < $3) ? 1 : 0
+}' || { [ $STATUS -ne 0 ] || STATUS=3; }
+exit $STATUS
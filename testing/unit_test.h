@@ -0,0 +1,39 @@
+#ifndef UNIT_TEST_H
+#define UNIT_TEST_H
+
+/*
+ * Apoio dos testes de unidade registrados no ctest.
+ * CHECK registra a falha e segue, para um teste mostrar todos os problemas de
+ * uma vez; main() termina com return TestResult().
+ */
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+#include <iostream>
+
+using namespace argos;
+
+/* número de verificações que falharam até agora */
+inline UInt32& TestFailures() {
+   static UInt32 unFailures = 0;
+   return unFailures;
+}
+
+#define CHECK(COND)                                                        \
+   do {                                                                    \
+      if(! (COND)) {                                                       \
+         std::cerr << __FILE__ << ":" << __LINE__ << ": falhou: " #COND     \
+                   << std::endl;                                           \
+         ++TestFailures();                                                 \
+      }                                                                    \
+   } while(0)
+
+/* código de saída do teste: 0 se nenhuma verificação falhou */
+inline int TestResult() {
+   if(TestFailures() > 0) {
+      std::cerr << TestFailures() << " verificação(ões) falharam" << std::endl;
+      return 1;
+   }
+   return 0;
+}
+
+#endif